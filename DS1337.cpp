@@ -24,7 +24,6 @@ THE SOFTWARE.
 
  */
 #include "DS1337.h"
-#include "Wire.h"
 
 /**
  * Constructor of class Date
@@ -88,49 +87,419 @@ void Date::setYear(int year) { _year = year; }
  * Get formatted time
  */
 String Date::getTimeString() {
-	char hhmmss[] = "00:00:00";
-	hhmmss[0] = getHour() / 10 + 48;
-	hhmmss[1] = getHour() % 10 + 48;
-	hhmmss[3] = getMinutes() / 10 + 48;
-	hhmmss[4] = getMinutes() % 10 + 48;
-	hhmmss[6] = getSeconds() / 10 + 48;
-	hhmmss[7] = getSeconds() % 10 + 48;
-	return String(hhmmss);
+	char hhmmss[DS1337_TIME_SIZE];
+	return String(formatTime(hhmmss));
 }
 
 /**
  * Get formatted date
  */
 String Date::getDateString() {
-	char hhmmss[] = "yy-mm-dd";
-	hhmmss[6] = getDay() / 10 + 48;
-	hhmmss[7] = getDay() % 10 + 48;
-	hhmmss[3] = getMonth() / 10 + 48;
-	hhmmss[4] = getMonth() % 10 + 48;
-	hhmmss[0] = getYear() / 10 + 48;
-	hhmmss[1] = getYear() % 10 + 48;
-	return String(hhmmss);
-}
-
-/**
- * Get unix timestamp
- */
-unsigned long Date::getTimestamp() {
-	return DS1337::getTimestamp(getYear(), getMonth(), getDay(), getHour(), getMinutes(), getSeconds());
-}
-
-/**
+	char yymmdd[DS1337_DATE_SIZE];
+	return String(formatDate(yymmdd));
+}
+
+/**
+ * Format time as hh:mm:ss into buffer (DS1337_TIME_SIZE bytes)
+ */
+char *Date::formatTime(char *buffer) {
+	format(buffer, DS1337_TIME_SIZE, "hh:mm:ss");
+	return buffer;
+}
+
+/**
+ * Format date as yy-mm-dd into buffer (DS1337_DATE_SIZE bytes)
+ */
+char *Date::formatDate(char *buffer) {
+	format(buffer, DS1337_DATE_SIZE, "YY-MM-DD");
+	return buffer;
+}
+
+/**
+ * Format date and time as YYYY-MM-DDThh:mm:ss into buffer (DS1337_ISO8601_SIZE bytes)
+ */
+char *Date::formatISO8601(char *buffer) {
+	format(buffer, DS1337_ISO8601_SIZE, "YYYY-MM-DDThh:mm:ss");
+	return buffer;
+}
+
+/**
+ * Format date and time as YYYYMMDDhhmmss into buffer (DS1337_COMPACT_SIZE bytes),
+ * e.g. for file names
+ */
+char *Date::formatCompact(char *buffer) {
+	format(buffer, DS1337_COMPACT_SIZE, "YYYYMMDDhhmmss");
+	return buffer;
+}
+
+/**
+ * Format date and time with a pattern into a buffer of size bytes.
+ * Placeholders: YYYY, YY, MM, DD, hh, mm, ss; all other characters are copied.
+ * Returns the length of the formatted string (truncated to size - 1).
+ */
+int Date::format(char *buffer, int size, const char *pattern) {
+	char token[4];
+	int length = 0;
+	if (size <= 0)
+		return 0;
+	while (*pattern) {
+		int n = formatToken(pattern, token);
+		for (int i=0; i<n && length<size-1; i++) {
+			buffer[length] = token[i];
+			length++;
+		}
+	}
+	buffer[length] = 0;
+	return length;
+}
+
+/**
+ * Print date and time with a pattern (see format) without a buffer
+ */
+size_t Date::print(Print &out, const char *pattern) {
+	char token[4];
+	size_t length = 0;
+	while (*pattern) {
+		int n = formatToken(pattern, token);
+		length += out.write((const uint8_t *)token, n);
+	}
+	return length;
+}
+
+/**
+ * Format the next placeholder or character of a pattern (max. 4 characters)
+ */
+int Date::formatToken(const char *&pattern, char *out) {
+	int value = -1;
+	int n = 2;
+	if (strncmp(pattern, "YYYY", 4) == 0) {
+		value = 2000 + getYear();
+		n = 4;
+	}
+	else if (strncmp(pattern, "YY", 2) == 0)
+		value = getYear() % 100;
+	else if (strncmp(pattern, "MM", 2) == 0)
+		value = getMonth();
+	else if (strncmp(pattern, "DD", 2) == 0)
+		value = getDay();
+	else if (strncmp(pattern, "hh", 2) == 0)
+		value = getHour();
+	else if (strncmp(pattern, "mm", 2) == 0)
+		value = getMinutes();
+	else if (strncmp(pattern, "ss", 2) == 0)
+		value = getSeconds();
+	if (value < 0) {
+		out[0] = *pattern;
+		pattern++;
+		return 1;
+	}
+	pattern += n;
+	for (int i=n-1; i>=0; i--) {
+		out[i] = value % 10 + 48;
+		value /= 10;
+	}
+	return n;
+}
+
+/**
+ * Get unix timestamp
+ */
+unsigned long Date::getTimestamp() {
+	return DS1337::getTimestamp(getYear(), getMonth(), getDay(), getHour(), getMinutes(), getSeconds());
+}
+
+/**
+ * Add seconds (negative to subtract) with carry into all fields, in constant time
+ */
+void Date::addSeconds(long seconds) {
+	DS1337::getTime(getTimestamp() + seconds, _year, _month, _day, _hour, _minutes, _seconds);
+}
+
+void Date::addMinutes(long minutes) {
+	addSeconds(minutes * (long)SECONDS_PER_MINUTE);
+}
+
+void Date::addHours(long hours) {
+	addSeconds(hours * (long)SECONDS_PER_HOUR);
+}
+
+void Date::addDays(long days) {
+	addSeconds(days * (long)SECONDS_PER_DAY);
+}
+
+/**
+ * Seconds from other date to this date (negative, if other is later)
+ */
+long Date::difference(Date other) {
+	return (long)(getTimestamp() - other.getTimestamp());
+}
+
+/**
+ * Compare with other date (-1 earlier, 0 same, 1 later)
+ */
+int Date::compare(Date other) {
+	long a[] = {_year, _month, _day, _hour, _minutes, _seconds};
+	long b[] = {other._year, other._month, other._day, other._hour, other._minutes, other._seconds};
+	for (int i=0; i<6; i++) {
+		if (a[i] != b[i])
+			return a[i] < b[i] ? -1 : 1;
+	}
+	return 0;
+}
+
+/**
+ * Number of days of the month of this date
+ */
+int Date::getDaysInMonth() {
+	return daysInMonth(_year, _month);
+}
+
+/**
+ * Day of week of this date (1 = Monday .. 7 = Sunday)
+ */
+int Date::getDayOfWeek() {
+	// 2000-01-01 was a Saturday
+	return (DS1337::getDays(_year, _month, _day) + 5) % 7 + 1;
+}
+
+/**
+ * Number of days of a month (year 0 is 2000, Gregorian leap years like getDays)
+ */
+int Date::daysInMonth(int year, int month) {
+	if (month == 2)
+		return (year % 4 == 0 && (year % 100 != 0 || year % 400 == 0)) ? 29 : 28;
+	return 30 + ((month + (month >> 3)) & 1);
+}
+
+/**
+ * Constructor of class DS1337EventQueue
+ */
+DS1337EventQueue::DS1337EventQueue() {
+	_head = 0;
+	_tail = 0;
+	_overflows = 0;
+}
+
+/**
+ * Push an event with the current micros (call from interrupt routine only)
+ */
+boolean DS1337EventQueue::push(byte kind) {
+	byte head = _head;
+	byte next = (head + 1) & (DS1337_EVENT_QUEUE_SIZE - 1);
+	if (next == _tail) {
+		_overflows++;
+		return false;
+	}
+	_events[head].kind = kind;
+	_events[head].micros = micros();
+	// publish the event after it is written
+	_head = next;
+	return true;
+}
+
+/**
+ * Pop the oldest event (call from main loop only)
+ */
+boolean DS1337EventQueue::pop(DS1337Event &event) {
+	byte tail = _tail;
+	if (tail == _head)
+		return false;
+	event = _events[tail];
+	_tail = (tail + 1) & (DS1337_EVENT_QUEUE_SIZE - 1);
+	return true;
+}
+
+/**
+ * Get the number of queued events
+ */
+byte DS1337EventQueue::available() {
+	return (_head - _tail) & (DS1337_EVENT_QUEUE_SIZE - 1);
+}
+
+/**
+ * Get the number of events lost, because the queue was full
+ */
+unsigned int DS1337EventQueue::getOverflows() {
+	unsigned int overflows;
+	noInterrupts();
+	overflows = _overflows;
+	interrupts();
+	return overflows;
+}
+
+/**
+ * Constructor of class DS1337Snapshot (empty)
+ */
+DS1337Snapshot::DS1337Snapshot() {
+	memset(_register, 0, DS1337_MAX_REGISTERS);
+	_registers = 0;
+}
+
+/**
+ * Constructor of class DS1337Snapshot with given registers
+ */
+DS1337Snapshot::DS1337Snapshot(const byte *registers, int countRegister) {
+	memset(_register, 0, DS1337_MAX_REGISTERS);
+	memcpy(_register, registers, countRegister);
+	_registers = countRegister;
+}
+
+/**
+ * Get date, day of week and alarms of the snapshot
+ */
+Date DS1337Snapshot::getDate() const {
+	Date d;
+	DS1337::decodeDate(_register, d);
+	return d;
+}
+
+int DS1337Snapshot::getDayOfWeek() const {
+	return _register[DS1337_DAY_OF_WEEK];
+}
+
+Date DS1337Snapshot::getAlarm() const {
+	Date d;
+	DS1337::decodeAlarm(_register, d);
+	return d;
+}
+
+Date DS1337Snapshot::getAlarm2() const {
+	Date d;
+	DS1337::decodeAlarm2(_register, d);
+	return d;
+}
+
+/**
+ * Get raw registers of the snapshot
+ */
+byte DS1337Snapshot::getControl() const { return _register[DS1337_CONTROL]; }
+byte DS1337Snapshot::getStatus() const { return _register[DS1337_STATUS]; }
+int DS1337Snapshot::getRegister(int i) const { return _register[i]; }
+
+/**
+ * Get flags of the snapshot
+ */
+boolean DS1337Snapshot::isRunning() const { return !bitRead(_register[DS1337_CONTROL], DS1337_EOSC); }
+boolean DS1337Snapshot::isAlarmEnabled() const { return bitRead(_register[DS1337_CONTROL], DS1337_A1IE); }
+boolean DS1337Snapshot::isAlarmActive() const { return bitRead(_register[DS1337_STATUS], DS1337_A1F); }
+boolean DS1337Snapshot::isTickActive() const { return bitRead(_register[DS1337_STATUS], DS1337_A2F); }
+boolean DS1337Snapshot::hasStopped() const { return bitRead(_register[DS1337_STATUS], DS1337_OSF); }
+
+/**
+ * Check, if the snapshot contains the temperature (DS3231 only)
+ */
+boolean DS1337Snapshot::hasTemperature() const {
+	return _registers == DS1337_MAX_REGISTERS;
+}
+
+/**
+ * Get the temperature (DS3231 only)
+ */
+float DS1337Snapshot::getTemperature() const {
+	return getTemperatureQuarters() / 4.0;
+}
+
+/**
+ * Get the temperature in quarter degrees (DS3231 only), the MSB is signed
+ */
+int DS1337Snapshot::getTemperatureQuarters() const {
+	return (int)(int8_t)_register[DS1337_MAX_REGISTERS - 2] * 4 + (_register[DS1337_MAX_REGISTERS - 1] >> 6);
+}
+
+/**
+ * Get unix timestamp of the snapshot
+ */
+unsigned long DS1337Snapshot::getTimestamp() const {
+	Date d = getDate();
+	return d.getTimestamp();
+}
+
+/**
+ * Check, if the snapshot holds registers (false after a failed read)
+ */
+boolean DS1337Snapshot::isValid() const {
+	return _registers > 0;
+}
+
+/**
  * Constructor of class DS1337
  */
-DS1337::DS1337() {
-	//init();
+DS1337::DS1337() : DS1337(DS1337Wire, DS1337Chip::registers, DS1337Chip::features) {
+	//init();
+}
+
+/**
+ * Constructor of class DS1337 with given register transport
+ */
+DS1337::DS1337(DS1337Transport &transport) : DS1337(transport, DS1337Chip::registers, DS1337Chip::features) {
+}
+
+/**
+ * Constructor of class DS1337 with given register transport and I2C address
+ */
+DS1337::DS1337(DS1337Transport &transport, byte address) : DS1337(transport, DS1337Chip::registers, DS1337Chip::features) {
+	_address = address;
+}
+
+/**
+ * Constructor for a chip variant (register count and features of its chip traits)
+ */
+DS1337::DS1337(DS1337Transport &transport, byte registers, byte features) {
+	_transport = &transport;
+	_address = DS1337_ID;
+	_registers = registers;
+	_features = features;
+	_cached = false;
+	_cacheValid = 0;
+	_transaction = false;
+	_dirty = 0;
+	_clearedFlags = 0;
+	_pointer = 0xFF;
+	_asyncState = DS1337_ASYNC_IDLE;
+	_asyncCallback = NULL;
+	_instant = 0;
+	_jumpedBack = false;
+	resetStats();
+}
+
+/**
+ * Set/Get the I2C address of the RTC
+ */
+void DS1337::setAddress(byte address) {
+	_address = address;
+	_pointer = 0xFF;
+}
+
+byte DS1337::getAddress() {
+	return _address;
+}
+
+/**
+ * Get the register transport
+ */
+DS1337Transport *DS1337::getTransport() {
+	return _transport;
+}
+
+/**
+ * Get the number of registers of the chip
+ */
+byte DS1337::getRegisterCount() {
+	return _registers;
+}
+
+/**
+ * Check, if the chip has a feature (DS1337_FEATURE_*)
+ */
+boolean DS1337::hasFeature(byte feature) {
+	return (_features & feature) == feature;
 }
 
 /**
  * Init
  */
 void DS1337::init() {
-	Wire.begin();
+	_transport->begin();
 	clear();
 	_date = Date();
 	_alarm = Date();
@@ -142,25 +511,59 @@ void DS1337::init() {
  * Clear registers
  */
 void DS1337::clear() {
-	for (int i=0; i<DS1337_REGISTERS; i++) {
+	for (int i=0; i<_registers; i++) {
 		_register[i] = 0;
 	}
+	_cacheValid = 0;
+	_dirty = 0;
+	_clearedFlags = 0;
 }
 
 /**
- * Read registers from DS1337
+ * Read registers from DS1337, returns false on a failed or short transfer
+ * (the registers not read keep their old contents)
  */
-void DS1337::read(int startRegister, int countRegister) {
-	Wire.beginTransmission(DS1337_ID);
-	Wire.write(startRegister);
-	Wire.endTransmission();
-	Wire.requestFrom(DS1337_ID, countRegister);
-    int reg = startRegister;
-	while (Wire.available() > 0) {
-		byte b = (byte)Wire.read();
-		_register[reg] = b;
-		reg++;
+boolean DS1337::read(int startRegister, int countRegister) {
+	// don't overwrite registers staged in a transaction, but always read the
+	// hardware flags (a staged status register has 1 for all flags kept)
+	unsigned long range = ((1UL << countRegister) - 1) << startRegister;
+	unsigned long dirty = _transaction ? (_dirty & range) : 0;
+	if (dirty == range && !bitRead(range, DS1337_STATUS))
+		return true;
+	byte staged[DS1337_MAX_REGISTERS];
+	memcpy(staged, _register, DS1337_MAX_REGISTERS);
+#ifdef DS1337_STATS
+	unsigned long start = micros();
+#endif
+	byte n = _transport->read(_address, startRegister, &_register[startRegister], countRegister);
+#ifdef DS1337_STATS
+	_stats.micros += micros() - start;
+	_stats.transactions += _transport->getReadTransactions();
+	_stats.reads++;
+	_stats.bytesRead += n;
+	_stats.busMicros += _transport->getReadMicros(countRegister);
+#endif
+	_pointer = startRegister + n;
+	_cacheValid |= (((1UL << n) - 1) << startRegister) & DS1337_CACHEABLE;
+	if (dirty) {
+		byte flags = _register[DS1337_STATUS] & DS1337_STATUS_FLAGS & ~_clearedFlags;
+		for (int i=startRegister; i<(countRegister+startRegister); i++) {
+			if (bitRead(dirty, i))
+				_register[i] = staged[i];
+		}
+		if (bitRead(dirty, DS1337_STATUS))
+			_register[DS1337_STATUS] = (_register[DS1337_STATUS] & ~DS1337_STATUS_FLAGS) | flags;
 	}
+	return n == countRegister;
+}
+
+/**
+ * Read registers from DS1337, if they are not cached
+ */
+void DS1337::fetch(int startRegister, int countRegister) {
+	unsigned long mask = ((1UL << countRegister) - 1) << startRegister;
+	if (!_cached || (_cacheValid & mask) != mask)
+		read(startRegister, countRegister);
 }
 
 /**
@@ -174,14 +577,14 @@ void DS1337::readDate() {
  * Read alarm 1 registers from DS1337
  */
 void DS1337::readAlarm1() {
-	read(DS1337_A1_SECONDS, DS1337_REGISTERS_A1);
+	fetch(DS1337_A1_SECONDS, DS1337_REGISTERS_A1);
 }
 
 /**
  * Read alarm 2 registers from DS1337
  */
 void DS1337::readAlarm2() {
-	read(DS1337_A2_MINUTES, DS1337_REGISTERS_A2);
+	fetch(DS1337_A2_MINUTES, DS1337_REGISTERS_A2);
 }
 
 /**
@@ -191,11 +594,26 @@ void DS1337::readStatus() {
 	read(DS1337_CONTROL, DS1337_REGISTERS_STATUS);
 }
 
+/**
+ * Read control register from DS1337, if not cached
+ */
+void DS1337::readControl() {
+	fetch(DS1337_CONTROL, 1);
+}
+
+/**
+ * Read status register (hardware flags) from DS1337
+ */
+void DS1337::readFlags() {
+	read(DS1337_STATUS, 1);
+}
+
 /**
  * Write date/time registers from DS1337
  */
 void DS1337::writeDate() {
 	write(DS1337_SECONDS, DS1337_REGISTERS_DATE);
+	_instant = 0;
 }
 
 /**
@@ -219,16 +637,79 @@ void DS1337::writeStatus() {
 	write(DS1337_CONTROL, DS1337_REGISTERS_STATUS);
 }
 
+/**
+ * Write control register to DS1337
+ */
+void DS1337::writeControl() {
+	write(DS1337_CONTROL, 1);
+}
+
+/**
+ * Write status register to DS1337 and clear only the given flags
+ * (all other flags are written as 1, which leaves them unchanged)
+ */
+void DS1337::writeFlags(byte clearFlags) {
+	fetch(DS1337_STATUS, 1);
+	keepFlags();
+	_register[DS1337_STATUS] &= ~clearFlags;
+	if (_transaction)
+		_clearedFlags |= clearFlags;
+	write(DS1337_STATUS, 1);
+}
+
+/**
+ * Set all hardware flags of the status register to 1, so they are
+ * not changed on write (except flags already cleared in a transaction)
+ */
+void DS1337::keepFlags() {
+	_register[DS1337_STATUS] |= DS1337_STATUS_FLAGS & ~_clearedFlags;
+}
+
 /**
  * Write registers to DS1337
  */
 void DS1337::write(int startRegister, int countRegister) {
-	Wire.beginTransmission(DS1337_ID);
-	Wire.write(startRegister);
-	for (int i=startRegister; i<(countRegister+startRegister); i++) {
-		Wire.write(_register[i]);
+	// stage registers until commit
+	if (_transaction) {
+		_dirty |= ((1UL << countRegister) - 1) << startRegister;
+		return;
 	}
-	Wire.endTransmission();
+#ifdef DS1337_STATS
+	unsigned long start = micros();
+#endif
+	byte n = _transport->write(_address, startRegister, &_register[startRegister], countRegister);
+#ifdef DS1337_STATS
+	_stats.micros += micros() - start;
+	_stats.transactions++;
+	_stats.writes++;
+	_stats.bytesWritten += n;
+	_stats.busMicros += _transport->getWriteMicros(countRegister);
+#endif
+	_pointer = startRegister + n;
+	_cacheValid |= (((1UL << n) - 1) << startRegister) & DS1337_CACHEABLE;
+}
+
+/**
+ * Get the bus statistics since the last reset. The counters are totals of all
+ * calls on this object, there are none per method: take a snapshot before and
+ * after an API call to get its cost. They stay 0, unless DS1337.cpp is compiled
+ * with DS1337_STATS.
+ */
+DS1337Stats DS1337::getStats() {
+	return _stats;
+}
+
+/**
+ * Reset the bus statistics
+ */
+void DS1337::resetStats() {
+	_stats.transactions = 0;
+	_stats.reads = 0;
+	_stats.writes = 0;
+	_stats.bytesRead = 0;
+	_stats.bytesWritten = 0;
+	_stats.micros = 0;
+	_stats.busMicros = 0;
 }
 
 /**
@@ -267,14 +748,21 @@ void DS1337::setTime(int hour, int minutes, int seconds) {
 }
 
 /**
-* Set the time with string in form of hh:mm or hh:mm:ss
+* Set the time with string in form of hh:mm or hh:mm:ss
+*/
+void DS1337::setTime(const String &time) {
+	setTime(time.c_str());
+}
+
+/**
+* Set the time with string in form of hh:mm or hh:mm:ss (returns DS1337_PARSE_*)
 */
-void DS1337::setTime(String time) {
-	time.trim();
-	if (time.length()==5)
-	setTime(time.substring(0, 2).toInt(), time.substring(3, 5).toInt());
-	else if (time.length()==8)
-		setTime(time.substring(0, 2).toInt(), time.substring(3, 5).toInt(), time.substring(6, 8).toInt());
+int DS1337::setTime(const char *time) {
+	int hour, minutes, seconds;
+	int result = parseTime(time, strlen(time), hour, minutes, seconds);
+	if (result == DS1337_PARSE_OK)
+		setTime(hour, minutes, seconds);
+	return result;
 }
 
 
@@ -290,46 +778,65 @@ void DS1337::setDate(int year, int month, int day) {
 }
 
 /**
-* Set the date with string of form yy-mm-dd
+* Set the date with string of form yy-mm-dd
 */
-void DS1337::setDate(String date) {
-	date.trim();
-	if (date.length()==8)
-	setDate(date.substring(0, 2).toInt(), date.substring(3, 5).toInt(), date.substring(6, 8).toInt());
+void DS1337::setDate(const String &date) {
+	setDate(date.c_str());
 }
 
 /**
-* Set the date and time with string of yy-mm-dd hh:mm
+* Set the date with string of form yy-mm-dd or YYYY-MM-DD (returns DS1337_PARSE_*)
 */
-void DS1337::setDateTime(String date) {
-	date.trim();
-	if (date.length()==14)
-	setDateTime(date.substring(0, 2).toInt(), date.substring(3, 5).toInt(), date.substring(6, 8).toInt(), date.substring(9, 11).toInt(), date.substring(12, 14).toInt(), 0);
+int DS1337::setDate(const char *date) {
+	int year, month, day;
+	int result = parseDate(date, strlen(date), year, month, day);
+	if (result == DS1337_PARSE_OK)
+		setDate(year, month, day);
+	return result;
+}
+
+/**
+* Set the date and time with string of yy-mm-dd hh:mm
+*/
+void DS1337::setDateTime(const String &date) {
+	setDateTime(date.c_str());
+}
+
+/**
+* Set the date and time with string of yy-mm-dd hh:mm[:ss], YYYY-MM-DDThh:mm:ss[Z],
+* YYYYMMDDhhmmss or a unix timestamp (returns DS1337_PARSE_*)
+*/
+int DS1337::setDateTime(const char *date) {
+	int year, month, day, hour, minutes, seconds;
+	int result = parseDateTime(date, strlen(date), year, month, day, hour, minutes, seconds);
+	if (result == DS1337_PARSE_OK)
+		setDateTime(year, month, day, hour, minutes, seconds);
+	return result;
 }
 
 /**
  * Start clock
  */
 void DS1337::start() {
-	readStatus();
+	readControl();
 	bitClear(_register[DS1337_CONTROL], DS1337_EOSC);
-	writeStatus();
+	writeControl();
 }
 
 /**
  * Stop clock
  */
 void DS1337::stop() {
-	readStatus();
+	readControl();
 	bitSet(_register[DS1337_CONTROL], DS1337_EOSC);
-	writeStatus();
+	writeControl();
 }
 
 /**
  * Check if clock is running
  */
 boolean DS1337::isRunning() {
-	readStatus();
+	readControl();
 	return !bitRead(_register[DS1337_CONTROL], DS1337_EOSC);
 }
 
@@ -338,15 +845,67 @@ boolean DS1337::isRunning() {
  */
 Date DS1337::getDate() {
 	readDate();
-	_date.setSeconds((_register[DS1337_SECONDS] & 0x0F) + 10 * (_register[DS1337_SECONDS] >> 4));
-	_date.setMinutes((_register[DS1337_MINUTES] & 0x0F) + 10 * (_register[DS1337_MINUTES] >> 4));
-	_date.setHour((_register[DS1337_HOUR] & 0x0F) + 10 * (_register[DS1337_HOUR] >> 4));
-	_date.setDay((_register[DS1337_DAY] & 0x0F) + 10 * (_register[DS1337_DAY] >> 4));
-	_date.setMonth((_register[DS1337_MONTH] & 0x0F) + 10 * ((_register[DS1337_MONTH] >> 4) & 0x01));
-	_date.setYear((_register[DS1337_YEAR] & 0x0F) + 10 * (_register[DS1337_YEAR] >> 4));
+	decodeDate(_register, _date);
 	return _date;
 }
 
+/**
+ * Get date, day of week and unix timestamp of one instant (one burst read).
+ * If the time is before the previous instant, the registers are read once more;
+ * if it's still before, hasJumpedBack() is true.
+ */
+unsigned long DS1337::getInstant(Date &date, int &dayOfWeek) {
+	unsigned long timestamp = 0;
+	for (int i=0; i<2; i++) {
+		readDate();
+		decodeDate(_register, _date);
+		timestamp = getTimestamp(_date.getYear(), _date.getMonth(), _date.getDay(), _date.getHour(), _date.getMinutes(), _date.getSeconds());
+		if (timestamp >= _instant)
+			break;
+	}
+	_jumpedBack = timestamp < _instant;
+	_instant = timestamp;
+	date = _date;
+	dayOfWeek = _register[DS1337_DAY_OF_WEEK];
+	return timestamp;
+}
+
+/**
+ * Wait for the next seconds edge (polls the seconds register only), then get
+ * the instant. So the values stay valid for almost a whole second.
+ * Without an edge within the timeout (ms) the instant is read anyway.
+ */
+unsigned long DS1337::getAlignedInstant(Date &date, int &dayOfWeek, unsigned long timeout) {
+	read(DS1337_SECONDS, 1);
+	byte seconds = _register[DS1337_SECONDS];
+	unsigned long start = millis();
+	while (millis() - start < timeout) {
+		read(DS1337_SECONDS, 1);
+		if (_register[DS1337_SECONDS] != seconds)
+			break;
+	}
+	return getInstant(date, dayOfWeek);
+}
+
+/**
+ * Check, if the last instant was before the previous one
+ */
+boolean DS1337::hasJumpedBack() {
+	return _jumpedBack;
+}
+
+/**
+ * Decode date from BCD date/time registers
+ */
+void DS1337::decodeDate(const byte *registers, Date &date) {
+	date.setSeconds((registers[DS1337_SECONDS] & 0x0F) + 10 * (registers[DS1337_SECONDS] >> 4));
+	date.setMinutes((registers[DS1337_MINUTES] & 0x0F) + 10 * (registers[DS1337_MINUTES] >> 4));
+	date.setHour((registers[DS1337_HOUR] & 0x0F) + 10 * (registers[DS1337_HOUR] >> 4));
+	date.setDay((registers[DS1337_DAY] & 0x0F) + 10 * (registers[DS1337_DAY] >> 4));
+	date.setMonth((registers[DS1337_MONTH] & 0x0F) + 10 * ((registers[DS1337_MONTH] >> 4) & 0x01));
+	date.setYear((registers[DS1337_YEAR] & 0x0F) + 10 * (registers[DS1337_YEAR] >> 4));
+}
+
 /**
  * Set the current date
  */
@@ -376,31 +935,55 @@ void DS1337::setDateTime(int year, int month, int day, int hour, int minutes, in
 }
 
 /**
- * Set the current date and time with a timestamp
- */
-void DS1337::setDateTime(unsigned long timestamp) {
-    int y,m,d,h,mm,s;
-	DS1337::getTime(timestamp, y, m, d, h, mm, s);
-    setDateTime(y, m, d, h, mm, s);
-}
-
-/**
+ * Set the current date and time with a timestamp
+ */
+void DS1337::setDateTime(unsigned long timestamp) {
+    int y,m,d,h,mm,s;
+	DS1337::getTime(timestamp, y, m, d, h, mm, s);
+    setDateTime(y, m, d, h, mm, s);
+}
+
+/**
  * Get the current alarm
  */
 Date DS1337::getAlarm() {
 	readAlarm1();
-	_alarm.setSeconds((_register[DS1337_A1_SECONDS] & 0x0F) + 10 * ((_register[DS1337_A1_SECONDS] >> 4) & 0x07));
-	_alarm.setMinutes((_register[DS1337_A1_MINUTES] & 0x0F) + 10 * ((_register[DS1337_A1_MINUTES] >> 4) & 0x07));
-	_alarm.setHour((_register[DS1337_A1_HOUR] & 0x0F) + 10 * ((_register[DS1337_A1_HOUR] >> 4) & 0x03));
-	_alarm.setDay((_register[DS1337_A1_DAY] & 0x0F) + 10 * ((_register[DS1337_A1_DAY] >> 4) & 0x03));
+	decodeAlarm(_register, _alarm);
 	return _alarm;
 }
 
+/**
+ * Decode alarm 1 from BCD alarm registers (alarm mode bits masked)
+ */
+void DS1337::decodeAlarm(const byte *registers, Date &alarm) {
+	alarm.setSeconds((registers[DS1337_A1_SECONDS] & 0x0F) + 10 * ((registers[DS1337_A1_SECONDS] >> 4) & 0x07));
+	alarm.setMinutes((registers[DS1337_A1_MINUTES] & 0x0F) + 10 * ((registers[DS1337_A1_MINUTES] >> 4) & 0x07));
+	alarm.setHour((registers[DS1337_A1_HOUR] & 0x0F) + 10 * ((registers[DS1337_A1_HOUR] >> 4) & 0x03));
+	alarm.setDay((registers[DS1337_A1_DAY] & 0x0F) + 10 * ((registers[DS1337_A1_DAY] >> 4) & 0x03));
+}
+
+/**
+ * Read all registers in one transaction
+ */
+DS1337Snapshot DS1337::snapshot() {
+	if (!read(DS1337_SECONDS, _registers))
+		return DS1337Snapshot();
+	decodeDate(_register, _date);
+	return DS1337Snapshot(_register, _registers);
+}
+
 /**
  * Set the current alarm
  */
 void DS1337::setAlarm(Date date) {
 	readAlarm1();
+	storeAlarm1(date);
+}
+
+/**
+ * Encode and write the alarm 1 registers (mask bits of the alarm mode are kept)
+ */
+void DS1337::storeAlarm1(Date date) {
 	_alarm = date;
 	_register[DS1337_A1_SECONDS] = (_register[DS1337_A1_SECONDS] & 0x80) + (date.getSeconds() % 10) + ((date.getSeconds() / 10) << 4);
 	_register[DS1337_A1_MINUTES] = (_register[DS1337_A1_MINUTES] & 0x80) + (date.getMinutes() % 10) + ((date.getMinutes() / 10) << 4);
@@ -410,14 +993,25 @@ void DS1337::setAlarm(Date date) {
 }
 
 /**
-* Set the alarm time with string in form of hh:mm or dd.hh:mm
+* Set the alarm time with string in form of hh:mm or dd.hh:mm
+*/
+void DS1337::setAlarm(const String &time) {
+	setAlarm(time.c_str());
+}
+
+/**
+* Set the alarm time with string in form of hh:mm or dd.hh:mm (returns DS1337_PARSE_*)
 */
-void DS1337::setAlarm(String time) {
-  time.trim();
-  if (time.length()==5)
-	  setAlarm(time.substring(0, 2).toInt(), time.substring(3, 5).toInt(), 0);
-  else if (time.length()==8)
-	  setAlarm(time.substring(0, 2).toInt(), time.substring(3, 5).toInt(), time.substring(6, 8).toInt(), 0);
+int DS1337::setAlarm(const char *time) {
+	int day, hour, minutes;
+	int result = parseAlarm(time, strlen(time), day, hour, minutes);
+	if (result == DS1337_PARSE_OK) {
+		if (day < 0)
+			setAlarm(hour, minutes, 0);
+		else
+			setAlarm(day, hour, minutes, 0);
+	}
+	return result;
 }
 
 /**
@@ -467,47 +1061,72 @@ void DS1337::setAlarm(int day, int hour, int minutes, int seconds) {
  * Alarm is enabled at current alarm + minutes
  */
 void DS1337::snooze(int minutes) {
-	clearAlarm();
+	boolean transaction = _transaction;
+	if (!transaction)
+		beginTransaction();
+	// date, alarm 1, control and status in one burst
+	read(DS1337_SECONDS, DS1337_STATUS + 1);
+	keepFlags();
+	bitClear(_register[DS1337_STATUS], DS1337_A1F);
+	write(DS1337_STATUS, 1);
 	if (minutes>0 && minutes<=60) {
-		Date _currentAlarm = getAlarm();
-		_currentAlarm.setMinutes(_currentAlarm.getMinutes()+minutes);
-		if (_currentAlarm.getMinutes()>60) {
-			_currentAlarm.setMinutes(_currentAlarm.getMinutes()-60);
-			_currentAlarm.setHour(_currentAlarm.getHour()+1);
-			if (_currentAlarm.getHour()>23) {
-				_currentAlarm.setHour(0);
-				_currentAlarm.setDay(_currentAlarm.getDay()+1);
+		Date now;
+		Date alarm;
+		decodeDate(_register, now);
+		decodeAlarm(_register, alarm);
+		if (bitRead(_register[DS1337_A1_DAY], DS1337_A1DYDT)) {
+			// day of week 1..7
+			long seconds = alarm.getHour() * SECONDS_PER_HOUR + (alarm.getMinutes() + minutes) * SECONDS_PER_MINUTE + alarm.getSeconds();
+			alarm.setTime(seconds / SECONDS_PER_HOUR % 24, seconds / SECONDS_PER_MINUTE % 60, seconds % 60);
+			if (seconds >= (long)SECONDS_PER_DAY)
+				alarm.setDay(alarm.getDay() % 7 + 1);
+		}
+		else {
+			// day of month: the alarm is in this month or (if the day has passed) in the next one
+			int year = now.getYear();
+			int month = now.getMonth();
+			if (alarm.getDay() < now.getDay() && ++month > 12) {
+				month = 1;
+				year++;
 			}
+			if (alarm.getDay() > Date::daysInMonth(year, month))
+				alarm.setDay(Date::daysInMonth(year, month));
+			Date next(year, month, alarm.getDay(), alarm.getHour(), alarm.getMinutes(), alarm.getSeconds());
+			next.addMinutes(minutes);
+			alarm.setTime(next.getHour(), next.getMinutes(), next.getSeconds());
+			alarm.setDay(next.getDay());
 		}
-		setAlarm(_currentAlarm);
+		storeAlarm1(alarm);
 	}
+	if (!transaction)
+		commit(DS1337_MAX_REGISTERS);
 }
 
 /**
  * Enable alarm
  */
 void DS1337::enableAlarm() {
-	readStatus();
+	readControl();
 	bitSet(_register[DS1337_CONTROL], DS1337_A1IE);
-	writeStatus();
+	if (_features & DS1337_FEATURE_ALARM_INTCN)
+		bitSet(_register[DS1337_CONTROL], DS1337_INTCN);
+	writeControl();
 }
 
 /**
  * Disable alarm
  */
 void DS1337::disableAlarm() {
-	readStatus();
+	readControl();
 	bitClear(_register[DS1337_CONTROL], DS1337_A1IE);
-	writeStatus();
+	writeControl();
 }
 
 /**
  * Clear alarm
  */
 void DS1337::clearAlarm() {
-	readStatus();
-	bitClear(_register[DS1337_STATUS], DS1337_A1F);
-	writeStatus();
+	writeFlags(_BV(DS1337_A1F));
 }
 
 /**
@@ -524,7 +1143,9 @@ void DS1337::clearAlarm() {
  * Check, if alarm is enabled
  */
 boolean DS1337::isAlarmEnabled() {
-	readStatus();
+	readControl();
+	if ((_features & DS1337_FEATURE_ALARM_INTCN) && !bitRead(_register[DS1337_CONTROL], DS1337_INTCN))
+		return false;
 	return bitRead(_register[DS1337_CONTROL], DS1337_A1IE);
 }
 
@@ -532,7 +1153,7 @@ boolean DS1337::isAlarmEnabled() {
  * Check, if alarm is active
  */
 boolean DS1337::isAlarmActive() {
-	readStatus();
+	readFlags();
 	return bitRead(_register[DS1337_STATUS], DS1337_A1F);
 }
 
@@ -540,97 +1161,121 @@ boolean DS1337::isAlarmActive() {
  * Check, if tick is active
  */
 boolean DS1337::isTickActive() {
-	readStatus();
+	readFlags();
 	return bitRead(_register[DS1337_STATUS], DS1337_A2F);
 }
 
 
 /**
  * Set the tick mode (every second or minuzte)
+ * Returns false, if alarm 2 is used and the tick needs it.
  */
-void DS1337::setTickMode(int tickMode) {
+boolean DS1337::setTickMode(int tickMode) {
+	fetch(DS1337_A2_MINUTES, DS1337_REGISTERS_A2 + DS1337_REGISTERS_STATUS);
+	boolean alarm2 = isAlarm2Used();
+	if (alarm2 && (tickMode==DS1337_TICK_EVERY_MINUTE || tickMode==DS1337_TICK_EVERY_HOUR))
+		return false;
 	if (tickMode==DS1337_NO_TICKS) {
-		readStatus();
 		bitSet(_register[DS1337_CONTROL], DS1337_INTCN);
-		bitClear(_register[DS1337_CONTROL], DS1337_A2IE);
+		if (!alarm2)
+			bitClear(_register[DS1337_CONTROL], DS1337_A2IE);
+		keepFlags();
 		bitClear(_register[DS1337_STATUS], DS1337_A2F);
 		writeStatus();
 		_tickMode = tickMode;
 	}
 	else if (tickMode==DS1337_TICK_EVERY_SECOND) {
-		readStatus();
 		bitClear(_register[DS1337_CONTROL], DS1337_INTCN);
-		bitClear(_register[DS1337_CONTROL], DS1337_A2IE);
+		if (!alarm2)
+			bitClear(_register[DS1337_CONTROL], DS1337_A2IE);
 		bitClear(_register[DS1337_CONTROL], DS1337_RS1);
 		bitClear(_register[DS1337_CONTROL], DS1337_RS2);
+		keepFlags();
 		bitClear(_register[DS1337_STATUS], DS1337_A2F);
 		writeStatus();
 		_tickMode = tickMode;
 	}
 	else if (tickMode==DS1337_TICK_EVERY_MINUTE) {
-		readStatus();
-		readAlarm2();
 		bitSet(_register[DS1337_CONTROL], DS1337_INTCN);
 		bitSet(_register[DS1337_CONTROL], DS1337_A2IE);
+		keepFlags();
 		bitClear(_register[DS1337_STATUS], DS1337_A2F);
 		bitSet(_register[DS1337_A2_MINUTES], DS1337_A2M2);
 		bitSet(_register[DS1337_A2_HOUR], DS1337_A2M3);
-		bitSet(_register[DS1337_A2_DAY], DS1337_A2M4);
-		writeAlarm2();
-		writeStatus();
+		_register[DS1337_A2_DAY] = DS1337_A2_TICK_DAY;
+		write(DS1337_A2_MINUTES, DS1337_REGISTERS_A2 + DS1337_REGISTERS_STATUS);
 		_tickMode = tickMode;
 	}
 	else if (tickMode==DS1337_TICK_EVERY_HOUR) {
-		readStatus();
-		readAlarm2();
 		bitSet(_register[DS1337_CONTROL], DS1337_INTCN);
 		bitSet(_register[DS1337_CONTROL], DS1337_A2IE);
+		keepFlags();
 		bitClear(_register[DS1337_STATUS], DS1337_A2F);
 		//bitClear(_register[DS1337_A2_MINUTES], DS1337_A2M2);
 		_register[DS1337_A2_MINUTES] = 0;
 		bitSet(_register[DS1337_A2_HOUR], DS1337_A2M3);
-		bitSet(_register[DS1337_A2_DAY], DS1337_A2M4);
-		writeAlarm2();
-		writeStatus();
+		_register[DS1337_A2_DAY] = DS1337_A2_TICK_DAY;
+		write(DS1337_A2_MINUTES, DS1337_REGISTERS_A2 + DS1337_REGISTERS_STATUS);
 		_tickMode = tickMode;
 	}
+	else
+		return false;
+	return true;
 }
 
 /**
  * Get the tick mode (second | minute)
  */
 int DS1337::getTickMode() {
-	readStatus();
-	readAlarm2();
+	fetch(DS1337_A2_MINUTES, DS1337_REGISTERS_A2 + 1);
 	bool intcn = bitRead(_register[DS1337_CONTROL], DS1337_INTCN);
-	bool a1ie = bitRead(_register[DS1337_CONTROL], DS1337_A1IE);
 	bool a2ie = bitRead(_register[DS1337_CONTROL], DS1337_A2IE);
 	bool rs1 = bitRead(_register[DS1337_CONTROL], DS1337_RS1);
 	bool rs2 = bitRead(_register[DS1337_CONTROL], DS1337_RS2);
-	bool a2m2 = bitRead(_register[DS1337_A2_MINUTES], DS1337_A2M2);
-	bool a2m3 = bitRead(_register[DS1337_A2_HOUR], DS1337_A2M3);
-	bool a2m4 = bitRead(_register[DS1337_A2_DAY], DS1337_A2M4);
-	bool dydt = bitRead(_register[DS1337_A2_DAY], DS1337_A2DYDT);
 	if (!intcn && !rs1 && !rs2 && !a2ie)
 		_tickMode = DS1337_TICK_EVERY_SECOND;
 	else if (intcn && !a2ie)
 		_tickMode = DS1337_NO_TICKS;
-	else if (intcn && a2ie && a2m4 && a2m3 && a2m2)
-		_tickMode = DS1337_TICK_EVERY_MINUTE;
-	else if (intcn && a2ie && a2m4 && a2m3 && _register[DS1337_A2_MINUTES]==0)
-		_tickMode = DS1337_TICK_EVERY_HOUR;
+	else if (intcn && isAlarm2Used())
+		_tickMode = DS1337_NO_TICKS;
+	else if (intcn && a2ie && isTickPattern())
+		_tickMode = (_register[DS1337_A2_MINUTES] == 0) ? DS1337_TICK_EVERY_HOUR : DS1337_TICK_EVERY_MINUTE;
 	else
 		_tickMode = DS1337_TICK_UNKNOWN;
 	return _tickMode;
 }
 
+/**
+ * Check, if the alarm 2 registers hold the pattern of the minute tick
+ * (A2M2, A2M3 set) or of the hour tick (minutes 00, A2M3 set), marked as
+ * tick by the day register (DS1337_A2_TICK_DAY). Registers must be fetched before.
+ */
+boolean DS1337::isTickPattern() {
+	bool a2m2 = bitRead(_register[DS1337_A2_MINUTES], DS1337_A2M2);
+	bool a2m3 = bitRead(_register[DS1337_A2_HOUR], DS1337_A2M3);
+	bool marker = (_register[DS1337_A2_DAY] & 0xC0) == DS1337_A2_TICK_DAY;
+	return marker && a2m3 && (a2m2 || _register[DS1337_A2_MINUTES] == 0);
+}
+
+/**
+ * Check, if alarm 2 is used as alarm: A2IE set (and INTCN on chips needing it for
+ * the alarms), but not as minute or hour tick. Decoded from the registers only,
+ * so it's still right after a reset of the MCU. Registers must be fetched before.
+ */
+boolean DS1337::isAlarm2Used() {
+	bool intcn = bitRead(_register[DS1337_CONTROL], DS1337_INTCN);
+	if (!bitRead(_register[DS1337_CONTROL], DS1337_A2IE))
+		return false;
+	if ((_features & DS1337_FEATURE_ALARM_INTCN) && !intcn)
+		return false;
+	return !(intcn && isTickPattern());
+}
+
 /**
  * Reset the tick flag (must be done in hour and minite tick mode)
  */
 void DS1337::resetTick() {
-	readStatus();
-	bitClear(_register[DS1337_STATUS], DS1337_A2F);
-	writeStatus();
+	writeFlags(_BV(DS1337_A2F));
 }
 
 /**
@@ -645,7 +1290,7 @@ int DS1337::getRegister(int i) {
  * Check, if clock has stopped (Oscillator Stop Flag is set)
  */
 boolean DS1337::hasStopped() {
-	readStatus();
+	readFlags();
 	return bitRead(_register[DS1337_STATUS], DS1337_OSF);
 }
 
@@ -653,20 +1298,228 @@ boolean DS1337::hasStopped() {
  * Clear the OSF (Oscillator Stop Flag)
  */
 void DS1337::clearOSF() {
-	readStatus();
-	bitClear(_register[DS1337_STATUS], DS1337_OSF);
-	writeStatus();
+	writeFlags(_BV(DS1337_OSF));
 }
 
 /**
  * Clear all flags
  */
 void DS1337::clearFlags() {
-	readStatus();
-	bitClear(_register[DS1337_STATUS], DS1337_OSF);
-	bitClear(_register[DS1337_STATUS], DS1337_A2F);
-	bitClear(_register[DS1337_STATUS], DS1337_A1F);
-	writeStatus();
+	writeFlags(DS1337_STATUS_FLAGS);
+}
+
+/**
+ * Request the current date without blocking: the date registers are
+ * read in small steps by poll() (returns false, if a request is pending)
+ */
+boolean DS1337::requestDate() {
+	if (_asyncState != DS1337_ASYNC_IDLE && _asyncState != DS1337_ASYNC_READY)
+		return false;
+	_asyncState = DS1337_ASYNC_READ;
+	_asyncNext = DS1337_SECONDS;
+	return true;
+}
+
+/**
+ * Do one step of a requested date read (one short bus transaction).
+ * Returns true, when the date is ready. The seconds are read again
+ * at the end; if they have rolled over, the read is restarted.
+ */
+boolean DS1337::poll() {
+	if (_asyncState != DS1337_ASYNC_READ && _asyncState != DS1337_ASYNC_CHECK)
+		return _asyncState == DS1337_ASYNC_READY;
+	byte next = (_asyncState == DS1337_ASYNC_READ) ? _asyncNext : DS1337_SECONDS;
+	// set register pointer first (also, if someone else has moved it)
+	if (_pointer != next) {
+		_pointer = _transport->point(_address, next) ? next : 0xFF;
+#ifdef DS1337_STATS
+		_stats.transactions++;
+		_stats.busMicros += _transport->getWriteMicros(0);
+#endif
+		return false;
+	}
+	byte count = 1;
+	byte *data = &_asyncRegister[DS1337_REGISTERS_DATE];
+	if (_asyncState == DS1337_ASYNC_READ) {
+		count = DS1337_REGISTERS_DATE - next;
+		if (count > DS1337_ASYNC_CHUNK)
+			count = DS1337_ASYNC_CHUNK;
+		data = &_asyncRegister[next];
+	}
+	byte n = _transport->receive(_address, data, count);
+#ifdef DS1337_STATS
+	_stats.transactions++;
+	_stats.reads++;
+	_stats.bytesRead += n;
+	_stats.busMicros += DS1337Transport::getBusMicros(1, 1 + count, _transport->getClock());
+#endif
+	_pointer += n;
+	if (_asyncState == DS1337_ASYNC_READ) {
+		_asyncNext += n;
+		if (_asyncNext >= DS1337_REGISTERS_DATE)
+			_asyncState = DS1337_ASYNC_CHECK;
+	}
+	else if (n == 1) {
+		if (_asyncRegister[DS1337_REGISTERS_DATE] < _asyncRegister[DS1337_SECONDS]) {
+			// seconds rolled over while reading: restart
+			_asyncState = DS1337_ASYNC_READ;
+			_asyncNext = DS1337_SECONDS;
+		}
+		else {
+			decodeDate(_asyncRegister, _asyncDate);
+			_asyncState = DS1337_ASYNC_READY;
+			if (_asyncCallback != NULL)
+				_asyncCallback(_asyncDate);
+		}
+	}
+	return _asyncState == DS1337_ASYNC_READY;
+}
+
+/**
+ * Check, if a requested date is ready
+ */
+boolean DS1337::isDateReady() {
+	return _asyncState == DS1337_ASYNC_READY;
+}
+
+/**
+ * Get the requested date (valid, if isDateReady)
+ */
+Date DS1337::getRequestedDate() {
+	return _asyncDate;
+}
+
+/**
+ * Set a callback called by poll(), when a requested date is ready
+ */
+void DS1337::onDate(void (*callback)(Date &date)) {
+	_asyncCallback = callback;
+}
+
+/**
+ * Drain all queued events, call the handler for each event and
+ * clear the alarm/tick flags of all events with one status write.
+ * Returns the number of events.
+ */
+int DS1337::processEvents(DS1337EventQueue &queue, void (*handler)(DS1337Event &event)) {
+	DS1337Event event;
+	byte flags = 0;
+	int count = 0;
+	while (queue.pop(event)) {
+		if (event.kind == DS1337_EVENT_ALARM)
+			bitSet(flags, DS1337_A1F);
+		else if (event.kind == DS1337_EVENT_TICK)
+			bitSet(flags, DS1337_A2F);
+		if (handler != NULL)
+			handler(event);
+		count++;
+	}
+	if (flags)
+		writeFlags(flags);
+	return count;
+}
+
+/**
+ * Begin a transaction: all following register writes are staged
+ * in RAM and written on commit in as few bursts as possible
+ */
+void DS1337::beginTransaction() {
+	// without cache, only registers read in the transaction are known
+	if (!_cached)
+		_cacheValid = 0;
+	_transaction = true;
+	_dirty = 0;
+	_clearedFlags = 0;
+}
+
+/**
+ * Commit a transaction: write the staged registers. Spans of dirty
+ * registers are merged, if the gap between them is small and the
+ * registers in the gap are known (cached alarm/control registers).
+ */
+void DS1337::commit() {
+	commit(DS1337_MERGE_GAP);
+}
+
+/**
+ * Commit a transaction with a given max. gap of known registers to merge
+ * (e.g. DS1337_MAX_REGISTERS to write all in one burst, if possible)
+ */
+void DS1337::commit(int mergeGap) {
+	_transaction = false;
+	// the staged status register may hold flags read back in the transaction
+	if (bitRead(_dirty, DS1337_STATUS))
+		keepFlags();
+	int reg = 0;
+	while (reg < DS1337_MAX_REGISTERS) {
+		if (!bitRead(_dirty, reg)) {
+			reg++;
+			continue;
+		}
+		int start = reg;
+		int end = reg + 1;
+		while (end < DS1337_MAX_REGISTERS) {
+			if (bitRead(_dirty, end)) {
+				end++;
+				continue;
+			}
+			// merge with next dirty span over a small gap of known registers
+			int gap = end;
+			while (gap < DS1337_MAX_REGISTERS && gap - end < mergeGap && !bitRead(_dirty, gap) && bitRead(_cacheValid & DS1337_CACHEABLE, gap))
+				gap++;
+			if (gap < DS1337_MAX_REGISTERS && bitRead(_dirty, gap)) {
+				if (end <= DS1337_STATUS && DS1337_STATUS < gap)
+					keepFlags();
+				end = gap;
+			}
+			else
+				break;
+		}
+		write(start, end - start);
+		reg = end;
+	}
+	_dirty = 0;
+	_clearedFlags = 0;
+}
+
+/**
+ * Check, if a transaction is open
+ */
+boolean DS1337::inTransaction() {
+	return _transaction;
+}
+
+/**
+ * Enable the register cache: alarm, control and status bits are kept
+ * in RAM (only the MCU changes them), so mutators only write
+ * and getAlarm/getAlarmMode/getTickMode/isAlarmEnabled don't touch the bus.
+ * Date and hardware flags are always read from DS1337.
+ */
+void DS1337::enableCache() {
+	_cacheValid = 0;
+	_cached = true;
+}
+
+/**
+ * Disable the register cache
+ */
+void DS1337::disableCache() {
+	_cached = false;
+}
+
+/**
+ * Check, if the register cache is enabled
+ */
+boolean DS1337::isCacheEnabled() {
+	return _cached;
+}
+
+/**
+ * Invalidate the register cache (e.g. after the DS1337 lost power
+ * or another master has written the registers)
+ */
+void DS1337::invalidateCache() {
+	_cacheValid = 0;
 }
 
 /**
@@ -750,64 +1603,450 @@ int DS1337::getAlarmMode() {
 }
 
 /**
- * Convert from unix timestamp
+ * Check, if alarm 2 can be used (it's not used by a minute or hour tick)
+ */
+boolean DS1337::isAlarm2Available() {
+	int tickMode = getTickMode();
+	return tickMode != DS1337_TICK_EVERY_MINUTE && tickMode != DS1337_TICK_EVERY_HOUR;
+}
+
+/**
+ * Set alarm 2 (day, hour, minutes), returns false on conflict with a tick
+ */
+boolean DS1337::setAlarm2(int day, int hour, int minutes) {
+	Date d = getAlarm2();
+	d.setDay(day);
+	d.setHour(hour);
+	d.setMinutes(minutes);
+	return setAlarm2(d);
+}
+
+/**
+ * Set alarm 2 (hour, minutes), returns false on conflict with a tick
+ */
+boolean DS1337::setAlarm2(int hour, int minutes) {
+	Date d = getAlarm2();
+	d.setHour(hour);
+	d.setMinutes(minutes);
+	return setAlarm2(d);
+}
+
+/**
+ * Set alarm 2 (seconds are ignored), returns false on conflict with a tick
+ */
+boolean DS1337::setAlarm2(Date date) {
+	if (!isAlarm2Available())
+		return false;
+	readAlarm2();
+	_register[DS1337_A2_MINUTES] = (_register[DS1337_A2_MINUTES] & 0x80) + (date.getMinutes() % 10) + ((date.getMinutes() / 10) << 4);
+	_register[DS1337_A2_HOUR] = (_register[DS1337_A2_HOUR] & 0x80) + (date.getHour() % 10) + ((date.getHour() / 10) << 4);
+	_register[DS1337_A2_DAY] = (_register[DS1337_A2_DAY] & 0xC0) + (date.getDay() % 10) + ((date.getDay() / 10) << 4);
+	// DY/DT is ignored with A2M4 set: clear it, so alarm 2 isn't marked as tick
+	if (bitRead(_register[DS1337_A2_DAY], DS1337_A2M4))
+		bitClear(_register[DS1337_A2_DAY], DS1337_A2DYDT);
+	writeAlarm2();
+	return true;
+}
+
+/**
+ * Get alarm 2
+ */
+Date DS1337::getAlarm2() {
+	readAlarm2();
+	Date d;
+	decodeAlarm2(_register, d);
+	return d;
+}
+
+/**
+ * Decode alarm 2 from BCD alarm registers (alarm mode bits masked)
  */
-void DS1337::getTime(unsigned long timestamp, int &year, int &month, int &day, int &hour, int &minute, int &second) {
-	timestamp-= T2000UTC;
+void DS1337::decodeAlarm2(const byte *registers, Date &alarm) {
+	alarm.setMinutes((registers[DS1337_A2_MINUTES] & 0x0F) + 10 * ((registers[DS1337_A2_MINUTES] >> 4) & 0x07));
+	alarm.setHour((registers[DS1337_A2_HOUR] & 0x0F) + 10 * ((registers[DS1337_A2_HOUR] >> 4) & 0x03));
+	alarm.setDay((registers[DS1337_A2_DAY] & 0x0F) + 10 * ((registers[DS1337_A2_DAY] >> 4) & 0x03));
+}
+
+/**
+ * Set the alarm 2 mode, returns false on conflict with a tick
+ */
+boolean DS1337::setAlarm2Mode(int alarmMode) {
+	if (!isAlarm2Available())
+		return false;
+	readAlarm2();
+	switch(alarmMode) {
+		case DS1337_ALARM2_EVERY_MINUTE:
+			bitSet(_register[DS1337_A2_MINUTES], DS1337_A2M2);
+			bitSet(_register[DS1337_A2_HOUR], DS1337_A2M3);
+			bitSet(_register[DS1337_A2_DAY], DS1337_A2M4);
+			bitClear(_register[DS1337_A2_DAY], DS1337_A2DYDT);
+			break;
+		case DS1337_ALARM2_ON_MINUTE:
+			bitClear(_register[DS1337_A2_MINUTES], DS1337_A2M2);
+			bitSet(_register[DS1337_A2_HOUR], DS1337_A2M3);
+			bitSet(_register[DS1337_A2_DAY], DS1337_A2M4);
+			bitClear(_register[DS1337_A2_DAY], DS1337_A2DYDT);
+			break;
+		case DS1337_ALARM2_ON_MINUTE_HOUR:
+			bitClear(_register[DS1337_A2_MINUTES], DS1337_A2M2);
+			bitClear(_register[DS1337_A2_HOUR], DS1337_A2M3);
+			bitSet(_register[DS1337_A2_DAY], DS1337_A2M4);
+			bitClear(_register[DS1337_A2_DAY], DS1337_A2DYDT);
+			break;
+		case DS1337_ALARM2_ON_MINUTE_HOUR_DATE:
+			bitClear(_register[DS1337_A2_MINUTES], DS1337_A2M2);
+			bitClear(_register[DS1337_A2_HOUR], DS1337_A2M3);
+			bitClear(_register[DS1337_A2_DAY], DS1337_A2M4);
+			bitClear(_register[DS1337_A2_DAY], DS1337_A2DYDT);
+			break;
+		case DS1337_ALARM2_ON_MINUTE_HOUR_DAY:
+			bitClear(_register[DS1337_A2_MINUTES], DS1337_A2M2);
+			bitClear(_register[DS1337_A2_HOUR], DS1337_A2M3);
+			bitClear(_register[DS1337_A2_DAY], DS1337_A2M4);
+			bitSet(_register[DS1337_A2_DAY], DS1337_A2DYDT);
+			break;
+	}
+	writeAlarm2();
+	return true;
+}
+
+/**
+ * Get the alarm 2 mode
+ */
+int DS1337::getAlarm2Mode() {
+	readAlarm2();
+	bool a2m2 = bitRead(_register[DS1337_A2_MINUTES], DS1337_A2M2);
+	bool a2m3 = bitRead(_register[DS1337_A2_HOUR], DS1337_A2M3);
+	bool a2m4 = bitRead(_register[DS1337_A2_DAY], DS1337_A2M4);
+	bool dydt = bitRead(_register[DS1337_A2_DAY], DS1337_A2DYDT);
+	if (a2m2 && a2m3 && a2m4)
+		return DS1337_ALARM2_EVERY_MINUTE;
+	else if (!a2m2 && a2m3 && a2m4)
+		return DS1337_ALARM2_ON_MINUTE;
+	else if (!a2m2 && !a2m3 && a2m4)
+		return DS1337_ALARM2_ON_MINUTE_HOUR;
+	else if (!a2m2 && !a2m3 && !a2m4 && !dydt)
+		return DS1337_ALARM2_ON_MINUTE_HOUR_DATE;
+	else if (!a2m2 && !a2m3 && !a2m4 && dydt)
+		return DS1337_ALARM2_ON_MINUTE_HOUR_DAY;
+	return DS1337_ALARM2_UNKNOWN;
+}
+
+/**
+ * Enable alarm 2, returns false on conflict with a tick
+ */
+boolean DS1337::enableAlarm2() {
+	if (!isAlarm2Available())
+		return false;
+	fetch(DS1337_A2_MINUTES, DS1337_REGISTERS_A2 + 1);
+	bitSet(_register[DS1337_CONTROL], DS1337_A2IE);
+	if (_features & DS1337_FEATURE_ALARM_INTCN)
+		bitSet(_register[DS1337_CONTROL], DS1337_INTCN);
+	// a disabled tick leaves its marker: the alarm takes alarm 2 over
+	if ((_register[DS1337_A2_DAY] & 0xC0) == DS1337_A2_TICK_DAY) {
+		bitClear(_register[DS1337_A2_DAY], DS1337_A2DYDT);
+		write(DS1337_A2_MINUTES, DS1337_REGISTERS_A2 + 1);
+	}
+	else
+		writeControl();
+	return true;
+}
+
+/**
+ * Disable alarm 2 (it can be used by ticks again)
+ */
+void DS1337::disableAlarm2() {
+	readControl();
+	bitClear(_register[DS1337_CONTROL], DS1337_A2IE);
+	writeControl();
+}
+
+/**
+ * Clear alarm 2 flag
+ */
+void DS1337::clearAlarm2() {
+	writeFlags(_BV(DS1337_A2F));
+}
+
+/**
+ * Check, if alarm 2 is enabled
+ */
+boolean DS1337::isAlarm2Enabled() {
+	fetch(DS1337_A2_MINUTES, DS1337_REGISTERS_A2 + 1);
+	return isAlarm2Used();
+}
+
+/**
+ * Check, if alarm 2 is active
+ */
+boolean DS1337::isAlarm2Active() {
+	readFlags();
+	return bitRead(_register[DS1337_STATUS], DS1337_A2F);
+}
+
+/**
+ * Convert from unix timestamp
+ */
+void DS1337::getTime(unsigned long timestamp, int &year, int &month, int &day, int &hour, int &minute, int &second) {
+	timestamp-= T2000UTC;
 	second = (int)(timestamp % 60);
 	timestamp = timestamp / 60;
 	minute = (int)(timestamp % 60);
 	timestamp = timestamp / 60;
 	hour = (int)(timestamp % 24);
-	timestamp = timestamp / 24;
-	year = 0;
-	int dYear = 0;
-	if (year % 4 == 0)
-		dYear = 366;
-	else
-		dYear = 365;
-	while (timestamp >= dYear) {
-		year++;
-		timestamp-=dYear;
-		if (year % 4 == 0)
-			dYear = 366;
-		else
-			dYear = 365;
+	getCivil(timestamp / 24, year, month, day);
+}
+
+/**
+ * Get unix timestamp
+ */
+unsigned long DS1337::getTimestamp(int year, int month, int day, int hour, int minute, int second) {
+	return getDays(year, month, day) * SECONDS_PER_DAY + hour * SECONDS_PER_HOUR + minute * SECONDS_PER_MINUTE + second + T2000UTC;
+}
+
+/**
+ * Get days since 2000-01-01 (year 0) of a date in constant time
+ * (gregorian calendar, years starting at March, see H. Hinnant "days_from_civil")
+ */
+unsigned long DS1337::getDays(int year, int month, int day) {
+	// shift by one 400 year cycle to stay positive in January/February 2000
+	unsigned long y = year + 400 - (month <= 2);
+	unsigned int m = month > 2 ? month - 3 : month + 9;
+	return 365 * y + y / 4 - y / 100 + y / 400 + (153 * m + 2) / 5 + day - 1 - DS1337_DAYS_2000;
+}
+
+/**
+ * Get date of days since 2000-01-01 (year 0) in constant time
+ * (see H. Hinnant "civil_from_days")
+ */
+void DS1337::getCivil(unsigned long days, int &year, int &month, int &day) {
+	// days since 2000-03-01 (start of a 400 year cycle), shifted by one cycle
+	unsigned long z = days + DS1337_DAYS_400_YEARS - 60;
+	unsigned int era = z >= DS1337_DAYS_400_YEARS;
+	unsigned long doe = z - era * DS1337_DAYS_400_YEARS;
+	unsigned int yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+	unsigned int doy = doe - (365UL * yoe + yoe / 4 - yoe / 100);
+	unsigned int m = (5 * doy + 2) / 153;
+	day = doy - (153 * m + 2) / 5 + 1;
+	month = m < 10 ? m + 3 : m - 9;
+	year = yoe + era * 400 - 400 + (month <= 2);
+}
+
+/**
+ * Convert many unix timestamps into separate arrays of the fields (same results as getTime).
+ * The loop has no branches and only 32 bit divisions by constants, so compilers can
+ * vectorize it (e.g. g++ -O3 with SSE/AVX2 on the host).
+ */
+void DS1337::getTime(const unsigned long *DS1337_RESTRICT timestamps, byte *DS1337_RESTRICT year, byte *DS1337_RESTRICT month, byte *DS1337_RESTRICT day, byte *DS1337_RESTRICT hour, byte *DS1337_RESTRICT minute, byte *DS1337_RESTRICT second, int count) {
+	for (int i=0; i<count; i++) {
+		uint32_t t = (uint32_t)timestamps[i] - (uint32_t)T2000UTC;
+		uint32_t days = t / (uint32_t)SECONDS_PER_DAY;
+		uint32_t s = t - days * (uint32_t)SECONDS_PER_DAY;
+		uint32_t h = s / (uint32_t)SECONDS_PER_HOUR;
+		s -= h * (uint32_t)SECONDS_PER_HOUR;
+		uint32_t mi = s / (uint32_t)SECONDS_PER_MINUTE;
+		// see getCivil
+		uint32_t z = days + DS1337_DAYS_400_YEARS - 60;
+		uint32_t era = z >= DS1337_DAYS_400_YEARS;
+		uint32_t doe = z - era * DS1337_DAYS_400_YEARS;
+		uint32_t yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+		uint32_t doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+		uint32_t m = (5 * doy + 2) / 153;
+		uint32_t mo = m < 10 ? m + 3 : m - 9;
+		year[i] = yoe + era * 400 - 400 + (mo <= 2);
+		month[i] = mo;
+		day[i] = doy - (153 * m + 2) / 5 + 1;
+		hour[i] = h;
+		minute[i] = mi;
+		second[i] = s - mi * (uint32_t)SECONDS_PER_MINUTE;
 	}
-	day = (int) timestamp;
-	int dayMonth[] = {0, 31, 59, 90, 120, 151, 181, 212, 243, 273, 304, 334};
-	month = 0;
-	while (day > dayMonth[month+1])
-		month++;
-	day-=dayMonth[month];
-	month++;
-	day++;
 }
 
 /**
- * Get unix timestamp
+ * Convert separate arrays of the fields into unix timestamps (same results as getTimestamp)
  */
-unsigned long DS1337::getTimestamp(int year, int month, int day, int hour, int minute, int second) {
-  unsigned long secMinute = 60;
-  unsigned long secHour = 60 * secMinute;
-  unsigned long secDay = 24 * secHour;
-  unsigned long secYear = 365 * secDay;
-  int dayMonth[] = {0, 31, 59, 90, 120, 151, 181, 212, 243, 273, 304, 334};
+void DS1337::getTimestamp(const byte *DS1337_RESTRICT year, const byte *DS1337_RESTRICT month, const byte *DS1337_RESTRICT day, const byte *DS1337_RESTRICT hour, const byte *DS1337_RESTRICT minute, const byte *DS1337_RESTRICT second, unsigned long *DS1337_RESTRICT timestamps, int count) {
+	for (int i=0; i<count; i++) {
+		// see getDays
+		uint32_t y = year[i] + 400 - (month[i] <= 2);
+		uint32_t m = month[i] > 2 ? month[i] - 3 : month[i] + 9;
+		uint32_t days = 365 * y + y / 4 - y / 100 + y / 400 + (153 * m + 2) / 5 + day[i] - 1 - DS1337_DAYS_2000;
+		timestamps[i] = days * (uint32_t)SECONDS_PER_DAY + hour[i] * (uint32_t)SECONDS_PER_HOUR + minute[i] * (uint32_t)SECONDS_PER_MINUTE + second[i] + (uint32_t)T2000UTC;
+	}
+}
 
-  // leap years
-  int leapDays = (year >> 2) + 1;
-  if (((year & 3) == 0) && month < 3)
-    leapDays--;
+/**
+ * Get unix timestamp
+ */
+unsigned long DS1337::getTimestamp() {
+	Date d = getDate();
+	return getTimestamp(d.getYear(), d.getMonth(), d.getDay(), d.getHour(), d.getMinutes(), d.getSeconds());
+}
 
-  // calculate
-  return year * secYear + (dayMonth[month-1] + (day-1) + leapDays) * secDay + hour * secHour + minute * secMinute + second + T2000UTC;
+/**
+ * Skip leading and trailing white space
+ */
+const char *DS1337::trim(const char *text, int &length) {
+	while (length > 0 && isspace(*text)) {
+		text++;
+		length--;
+	}
+	while (length > 0 && isspace(text[length-1]))
+		length--;
+	return text;
 }
 
-/**
- * Get unix timestamp
- */
-unsigned long DS1337::getTimestamp() {
-	Date d = getDate();
-	return getTimestamp(d.getYear(), d.getMonth(), d.getDay(), d.getHour(), d.getMinutes(), d.getSeconds());
+/**
+ * Parse a number of some digits (-1, if not all are digits)
+ */
+int DS1337::parseNumber(const char *text, int digits) {
+	int value = 0;
+	for (int i=0; i<digits; i++) {
+		if (!isdigit(text[i]))
+			return -1;
+		value = value * 10 + (text[i] - 48);
+	}
+	return value;
 }
 
+/**
+ * Check, if a character separates numbers (anything but a digit)
+ */
+boolean DS1337::isSeparator(char c) {
+	return !isdigit(c);
+}
+
+/**
+ * Check ranges of a date (year 0..99)
+ */
+int DS1337::checkDate(int year, int month, int day) {
+	if (year < 0 || year > 99 || month < 1 || month > 12 || day < 1 || day > 31)
+		return DS1337_PARSE_RANGE;
+	int y, m, d;
+	getCivil(getDays(year, month, day), y, m, d);
+	if (d != day)
+		return DS1337_PARSE_RANGE;
+	return DS1337_PARSE_OK;
+}
+
+/**
+ * Check ranges of a time
+ */
+int DS1337::checkTime(int hour, int minutes, int seconds) {
+	if (hour > 23 || minutes > 59 || seconds > 59)
+		return DS1337_PARSE_RANGE;
+	return DS1337_PARSE_OK;
+}
+
+/**
+ * Parse time of form hh:mm or hh:mm:ss (any non-digit separates)
+ */
+int DS1337::parseTime(const char *text, int length, int &hour, int &minutes, int &seconds) {
+	text = trim(text, length);
+	if ((length != 5 && length != 8) || isSeparator(text[0]) || !isSeparator(text[2]))
+		return DS1337_PARSE_FORMAT;
+	hour = parseNumber(text, 2);
+	minutes = parseNumber(text + 3, 2);
+	seconds = 0;
+	if (length == 8) {
+		if (!isSeparator(text[5]))
+			return DS1337_PARSE_FORMAT;
+		seconds = parseNumber(text + 6, 2);
+	}
+	if (hour < 0 || minutes < 0 || seconds < 0)
+		return DS1337_PARSE_FORMAT;
+	return checkTime(hour, minutes, seconds);
+}
+
+/**
+ * Parse date of form yy-mm-dd or YYYY-MM-DD (any non-digit separates)
+ */
+int DS1337::parseDate(const char *text, int length, int &year, int &month, int &day) {
+	text = trim(text, length);
+	int digits = length - 6;
+	if ((digits != 2 && digits != 4) || !isSeparator(text[digits]) || !isSeparator(text[digits+3]))
+		return DS1337_PARSE_FORMAT;
+	year = parseNumber(text, digits);
+	month = parseNumber(text + digits + 1, 2);
+	day = parseNumber(text + digits + 4, 2);
+	if (year < 0 || month < 0 || day < 0)
+		return DS1337_PARSE_FORMAT;
+	if (digits == 4)
+		year -= 2000;
+	return checkDate(year, month, day);
+}
+
+/**
+ * Parse date and time of form yy-mm-dd hh:mm[:ss], YYYY-MM-DDThh:mm:ss[Z],
+ * YYYYMMDDhhmmss or a unix timestamp (up to ten digits)
+ */
+int DS1337::parseDateTime(const char *text, int length, int &year, int &month, int &day, int &hour, int &minutes, int &seconds) {
+	text = trim(text, length);
+	int result;
+	int digits = 0;
+	while (digits < length && isdigit(text[digits]))
+		digits++;
+	// compact form or unix timestamp
+	if (digits == length && (length == 14 || (length > 0 && length <= 10))) {
+		unsigned long timestamp = 0;
+		for (int i=0; i<length && length<=10; i++)
+			timestamp = timestamp * 10 + (text[i] - 48);
+		if (length == 14) {
+			year = parseNumber(text, 4) - 2000;
+			month = parseNumber(text + 4, 2);
+			day = parseNumber(text + 6, 2);
+			hour = parseNumber(text + 8, 2);
+			minutes = parseNumber(text + 10, 2);
+			seconds = parseNumber(text + 12, 2);
+		}
+		else {
+			if (length == 10 && text[0] > '4')
+				return DS1337_PARSE_RANGE;
+			if (timestamp < T2000UTC)
+				return DS1337_PARSE_RANGE;
+			getTime(timestamp, year, month, day, hour, minutes, seconds);
+		}
+	}
+	// ISO 8601 with optional UTC designator
+	else if (length == 19 || (length == 20 && text[19] == 'Z')) {
+		if ((result = parseDate(text, 10, year, month, day)) != DS1337_PARSE_OK)
+			return result;
+		if (text[10] != 'T' && text[10] != ' ')
+			return DS1337_PARSE_FORMAT;
+		if ((result = parseTime(text + 11, 8, hour, minutes, seconds)) != DS1337_PARSE_OK)
+			return result;
+	}
+	// yy-mm-dd hh:mm[:ss]
+	else if ((length == 14 || length == 17) && isSeparator(text[8])) {
+		if ((result = parseDate(text, 8, year, month, day)) != DS1337_PARSE_OK)
+			return result;
+		if ((result = parseTime(text + 9, length - 9, hour, minutes, seconds)) != DS1337_PARSE_OK)
+			return result;
+	}
+	else
+		return DS1337_PARSE_FORMAT;
+	if ((result = checkDate(year, month, day)) != DS1337_PARSE_OK)
+		return result;
+	return checkTime(hour, minutes, seconds);
+}
+
+/**
+ * Parse alarm of form hh:mm or dd.hh:mm (day is -1, if not given)
+ */
+int DS1337::parseAlarm(const char *text, int length, int &day, int &hour, int &minutes) {
+	text = trim(text, length);
+	int seconds;
+	day = -1;
+	if (length == 8) {
+		if (!isSeparator(text[2]))
+			return DS1337_PARSE_FORMAT;
+		day = parseNumber(text, 2);
+		if (day < 0)
+			return DS1337_PARSE_FORMAT;
+		if (day < 1 || day > 31)
+			return DS1337_PARSE_RANGE;
+		text += 3;
+		length -= 3;
+	}
+	return parseTime(text, length, hour, minutes, seconds);
+}
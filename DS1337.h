@@ -28,21 +28,29 @@ THE SOFTWARE.
 
 // includes
 #include <Arduino.h>
+#include "DS1337Transport.h"
 
 // byte
 typedef uint8_t byte;
 
+// bus statistics (uncomment to count transactions, bytes and time of read/write;
+// only DS1337.cpp depends on it, the class is the same with or without)
+// #define DS1337_STATS
+
 
 // constants
-#define SECONDS_PER_MINUTE    UL60
-#define SECONDS_PER_HOUR    UL3600
-#define SECONDS_PER_DAY    UL86400
+#define SECONDS_PER_MINUTE    60UL
+#define SECONDS_PER_HOUR    3600UL
+#define SECONDS_PER_DAY    86400UL
 
 // DS1337 I2C BUS ID
 #define DS1337_ID  B1101000
 
 // DS1337 registers
 #define DS1337_REGISTERS   		16
+// register buffers are sized for the largest chip (DS3231), so a DS1337 object
+// or snapshot carries 3 unused bytes
+#define DS1337_MAX_REGISTERS    19
 #define DS1337_REGISTERS_DATE    7
 #define DS1337_REGISTERS_A1      4
 #define DS1337_REGISTERS_A2      3
@@ -64,6 +72,9 @@ typedef uint8_t byte;
 #define DS1337_CONTROL     0x0E
 #define DS1337_STATUS      0x0F
 
+// chip features (temperature, 32kHz and aging offset are the methods of class DS3231)
+#define DS1337_FEATURE_ALARM_INTCN	0x01
+
 // DS1337 control register flags
 #define DS1337_A1IE 	0x00
 #define DS1337_A2IE 	0x01
@@ -77,6 +88,15 @@ typedef uint8_t byte;
 #define DS1337_A2F 		0x01
 #define DS1337_OSF		0x07
 
+// DS1337 status register flags set by the hardware (writing 1 leaves them unchanged)
+#define DS1337_STATUS_FLAGS	0x83
+
+// max. gap of known registers written to merge two dirty spans on commit
+#define DS1337_MERGE_GAP	2
+
+// registers only changed by the MCU (alarms, control, status/aging bits), may be cached
+#define DS1337_CACHEABLE	0x0001FF80UL
+
 // DS1337 tick modes
 #define DS1337_TICK_UNKNOWN			0xFF
 #define DS1337_NO_TICKS				0x00
@@ -93,6 +113,14 @@ typedef uint8_t byte;
 #define DS1337_ALARM_ON_SECOND_MINUTE_HOUR_DAY  0x05
 #define DS1337_ALARM_UNKNOWN					0xFF
 
+// DS1337 alarm 2 modes
+#define DS1337_ALARM2_EVERY_MINUTE				0x00
+#define DS1337_ALARM2_ON_MINUTE					0x01
+#define DS1337_ALARM2_ON_MINUTE_HOUR			0x02
+#define DS1337_ALARM2_ON_MINUTE_HOUR_DATE		0x03
+#define DS1337_ALARM2_ON_MINUTE_HOUR_DAY		0x04
+#define DS1337_ALARM2_UNKNOWN					0xFF
+
 // DS1337 alarm mode register
 #define DS1337_A1M1		7
 #define DS1337_A1M2		7
@@ -104,9 +132,87 @@ typedef uint8_t byte;
 #define DS1337_A2M4		7
 #define DS1337_A2DYDT	6
 
+// alarm 2 day register of the minute/hour tick: A2M4 and DY/DT set, day 0
+// (DY/DT is ignored with A2M4 set, an alarm 2 of the user never has it)
+#define DS1337_A2_TICK_DAY	0xC0
+
 // Helpers
 #define	T2000UTC 	946684800UL
+#define DS1337_DAYS_400_YEARS	146097UL
+#define DS1337_DAYS_2000		146037UL
+
+// asynchronous date read
+#define DS1337_ASYNC_CHUNK		2
+#define DS1337_ASYNC_IDLE		0x00
+#define DS1337_ASYNC_READ		0x01
+#define DS1337_ASYNC_CHECK		0x02
+#define DS1337_ASYNC_READY		0x03
 
+// interrupt event queue (size must be a power of two)
+#define DS1337_EVENT_QUEUE_SIZE	8
+#define DS1337_EVENT_ALARM		0x01
+#define DS1337_EVENT_TICK		0x02
+
+// buffer sizes of formatted dates (including terminating zero)
+#define DS1337_TIME_SIZE		9
+#define DS1337_DATE_SIZE		9
+#define DS1337_ISO8601_SIZE		20
+#define DS1337_COMPACT_SIZE		15
+
+
+// chip traits of the DS1337 (compile-time constants, copied into the object by the
+// constructor: DS3231 must stay usable as DS1337&, so both share one class layout)
+struct DS1337Chip {
+	static const byte registers = DS1337_REGISTERS;
+	static const byte features = 0;
+};
+
+// bus statistics of a DS1337 object
+struct DS1337Stats {
+	unsigned long transactions;
+	unsigned long reads;
+	unsigned long writes;
+	unsigned long bytesRead;
+	unsigned long bytesWritten;
+	unsigned long micros;
+	unsigned long busMicros;
+};
+
+// arrays of the batch conversions don't overlap (lets compilers vectorize)
+#if defined(__GNUC__)
+#define DS1337_RESTRICT __restrict__
+#else
+#define DS1337_RESTRICT
+#endif
+
+// max. wait (ms) for the next seconds edge of an aligned read
+#define DS1337_ALIGN_TIMEOUT	1100UL
+
+// parser results
+#define DS1337_PARSE_OK			0
+#define DS1337_PARSE_FORMAT		1
+#define DS1337_PARSE_RANGE		2
+
+// event pushed by an interrupt routine
+struct DS1337Event {
+	byte kind;
+	unsigned long micros;
+};
+
+// class definition of a single producer (interrupt) / single consumer event queue
+class DS1337EventQueue {
+	public:
+		DS1337EventQueue();
+		boolean push(byte kind);
+		boolean pop(DS1337Event &event);
+		byte available();
+		unsigned int getOverflows();
+	private:
+		DS1337Event _events[DS1337_EVENT_QUEUE_SIZE];
+		volatile byte _head;
+		volatile byte _tail;
+		volatile unsigned int _overflows;
+};
 
 // class definition of Date object
 class Date {
@@ -130,8 +236,24 @@ class Date {
 		void setDate(int year, int month, int day);
 		String getTimeString();
 		String getDateString();
+		char *formatTime(char *buffer);
+		char *formatDate(char *buffer);
+		char *formatISO8601(char *buffer);
+		char *formatCompact(char *buffer);
+		int format(char *buffer, int size, const char *pattern);
+		size_t print(Print &out, const char *pattern);
 		unsigned long getTimestamp();
+		void addSeconds(long seconds);
+		void addMinutes(long minutes);
+		void addHours(long hours);
+		void addDays(long days);
+		long difference(Date other);
+		int compare(Date other);
+		int getDaysInMonth();
+		int getDayOfWeek();
+		static int daysInMonth(int year, int month);
 	private:
+		int formatToken(const char *&pattern, char *out);
 		int _seconds;
 		int _minutes;
 		int _hour;
@@ -140,28 +262,69 @@ class Date {
 		int _year;
 };
 
+// class definition of a snapshot of all DS1337/DS3231 registers
+class DS1337Snapshot {
+	public:
+		DS1337Snapshot();
+		DS1337Snapshot(const byte *registers, int countRegister);
+		Date getDate() const;
+		int getDayOfWeek() const;
+		Date getAlarm() const;
+		Date getAlarm2() const;
+		byte getControl() const;
+		byte getStatus() const;
+		int getRegister(int i) const;
+		boolean isRunning() const;
+		boolean isAlarmEnabled() const;
+		boolean isAlarmActive() const;
+		boolean isTickActive() const;
+		boolean hasStopped() const;
+		boolean hasTemperature() const;
+		float getTemperature() const;
+		int getTemperatureQuarters() const;
+		unsigned long getTimestamp() const;
+		boolean isValid() const;
+	private:
+		byte _register[DS1337_MAX_REGISTERS];
+		byte _registers;
+};
+
 // class definition of DS1337 RTC
 class DS1337 {
 	public:
 		DS1337();
+		DS1337(DS1337Transport &transport);
+		DS1337(DS1337Transport &transport, byte address);
 		void init();
+		void setAddress(byte address);
+		byte getAddress();
+		DS1337Transport *getTransport();
+		byte getRegisterCount();
+		boolean hasFeature(byte feature);
 		void setTime(int hour, int minutes);
 		void setTime(int hour, int minutes, int seconds);
-		void setTime(String time);
+		void setTime(const String &time);
+		int setTime(const char *time);
 		void setDate(int year, int month, int day);
-		void setDate(String date);
+		void setDate(const String &date);
+		int setDate(const char *date);
 		void setDateTime(int year, int month, int day, int hour, int minutes, int seconds);
-		void setDateTime(String date);
+		void setDateTime(const String &date);
+		int setDateTime(const char *date);
 		void setDateTime(unsigned long timestamp);
 		void start();
 		void stop();
 		boolean isRunning();
 		void setDate(Date date);
 		Date getDate();
+		unsigned long getInstant(Date &date, int &dayOfWeek);
+		unsigned long getAlignedInstant(Date &date, int &dayOfWeek, unsigned long timeout = DS1337_ALIGN_TIMEOUT);
+		boolean hasJumpedBack();
 		void setAlarm(int day, int hour, int minutes, int seconds);
 		void setAlarm(int hour, int minutes, int seconds);
 		void setAlarm(Date date);
-		void setAlarm(String date);
+		void setAlarm(const String &date);
+		int setAlarm(const char *date);
 		void snooze(int minutes);
 		void saveAlarm();
 		void restoreAlarm();
@@ -174,7 +337,7 @@ class DS1337 {
 		boolean isAlarmActive();
 		int getRegister(int i);
 		boolean isTickActive();
-		void setTickMode(int tickMode);
+		boolean setTickMode(int tickMode);
 		int getTickMode();
 		void resetTick();
 		int getDayOfWeek();
@@ -184,28 +347,101 @@ class DS1337 {
 		void clearFlags();
 		void setAlarmMode(int alarmMode);
 		int getAlarmMode();
+		boolean setAlarm2(int day, int hour, int minutes);
+		boolean setAlarm2(int hour, int minutes);
+		boolean setAlarm2(Date date);
+		Date getAlarm2();
+		boolean setAlarm2Mode(int alarmMode);
+		int getAlarm2Mode();
+		boolean enableAlarm2();
+		void disableAlarm2();
+		void clearAlarm2();
+		boolean isAlarm2Enabled();
+		boolean isAlarm2Active();
+		boolean isAlarm2Available();
 		static void getTime(unsigned long timestamp, int &year, int &month, int &day, int &hour, int &minute, int &second);
 		static unsigned long getTimestamp(int year, int month, int day, int hour, int minute, int second);
+		static unsigned long getDays(int year, int month, int day);
+		static void getTime(const unsigned long *DS1337_RESTRICT timestamps, byte *DS1337_RESTRICT year, byte *DS1337_RESTRICT month, byte *DS1337_RESTRICT day, byte *DS1337_RESTRICT hour, byte *DS1337_RESTRICT minute, byte *DS1337_RESTRICT second, int count);
+		static void getTimestamp(const byte *DS1337_RESTRICT year, const byte *DS1337_RESTRICT month, const byte *DS1337_RESTRICT day, const byte *DS1337_RESTRICT hour, const byte *DS1337_RESTRICT minute, const byte *DS1337_RESTRICT second, unsigned long *DS1337_RESTRICT timestamps, int count);
+		static void getCivil(unsigned long days, int &year, int &month, int &day);
+		static int parseTime(const char *text, int length, int &hour, int &minutes, int &seconds);
+		static int parseDate(const char *text, int length, int &year, int &month, int &day);
+		static int parseDateTime(const char *text, int length, int &year, int &month, int &day, int &hour, int &minutes, int &seconds);
+		static int parseAlarm(const char *text, int length, int &day, int &hour, int &minutes);
 		unsigned long getTimestamp();
+		DS1337Snapshot snapshot();
+		boolean requestDate();
+		boolean poll();
+		boolean isDateReady();
+		Date getRequestedDate();
+		void onDate(void (*callback)(Date &date));
+		int processEvents(DS1337EventQueue &queue, void (*handler)(DS1337Event &event));
+		static void decodeDate(const byte *registers, Date &date);
+		static void decodeAlarm(const byte *registers, Date &alarm);
+		static void decodeAlarm2(const byte *registers, Date &alarm);
+		void beginTransaction();
+		void commit();
+		void commit(int mergeGap);
+		boolean inTransaction();
+		void enableCache();
+		void disableCache();
+		boolean isCacheEnabled();
+		void invalidateCache();
+		DS1337Stats getStats();
+		void resetStats();
 	protected:
+		DS1337(DS1337Transport &transport, byte registers, byte features);
 		void readStatus();
 		void writeStatus();
-		byte _register[DS1337_REGISTERS];
+		byte _register[DS1337_MAX_REGISTERS];
 		int _tickMode;
+		boolean isTickPattern();
+		boolean isAlarm2Used();
 		void readAlarm2();
 		void writeAlarm2();
 		void clear();
-		void read(int startRegister, int countRegister);
+		boolean read(int startRegister, int countRegister);
+		void write(int startRegister, int countRegister);
+		void fetch(int startRegister, int countRegister);
+		void readControl();
+		void writeControl();
+		void readFlags();
+		void writeFlags(byte clearFlags);
+		void keepFlags();
+		DS1337Transport *_transport;
+		byte _address;
+		byte _registers;
+		byte _features;
+		byte _pointer;
+		boolean _cached;
+		unsigned long _cacheValid;
+		boolean _transaction;
+		unsigned long _dirty;
+		byte _clearedFlags;
 	private:
+		static const char *trim(const char *text, int &length);
+		static int parseNumber(const char *text, int digits);
+		static boolean isSeparator(char c);
+		static int checkDate(int year, int month, int day);
+		static int checkTime(int hour, int minutes, int seconds);
 		void readDate();
 		void readAlarm1();
-		void write(int startRegister, int countRegister);
 		void writeDate();
 		void writeAlarm1();
+		void storeAlarm1(Date date);
 		Date _date;
 		Date _alarm;
 		Date _savedAlarm;
 		int _alarmMode;
+		byte _asyncState;
+		byte _asyncNext;
+		byte _asyncRegister[DS1337_REGISTERS_DATE + 1];
+		Date _asyncDate;
+		void (*_asyncCallback)(Date &date);
+		unsigned long _instant;
+		boolean _jumpedBack;
+		DS1337Stats _stats;
 };
 
 #endif
@@ -0,0 +1,157 @@
+/**
+
+DS1337Clock.cpp
+
+Copyright by Christian Paul, 2014
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+ */
+#include "DS1337Clock.h"
+
+/**
+ * Constructor of class DS1337Clock
+ */
+DS1337Clock::DS1337Clock(DS1337 &rtc) {
+	_rtc = &rtc;
+	_seconds = 0;
+	_anchor = 0;
+	_aligned = false;
+	_lastSync = 0;
+	_lastSeconds = 0;
+	_lastMilliseconds = 0;
+	_interval = DS1337_CLOCK_SYNC_INTERVAL;
+	_tolerance = DS1337_CLOCK_TOLERANCE;
+}
+
+/**
+ * Init: read the RTC once
+ */
+void DS1337Clock::begin() {
+	sync();
+}
+
+/**
+ * Read the RTC again. If the clock is aligned by a tick, only the whole seconds
+ * are corrected and the phase is kept; else the phase is unknown until the next tick
+ */
+void DS1337Clock::sync() {
+	unsigned long error = getError();
+	unsigned long timestamp = _rtc->getTimestamp();
+	unsigned long now = millis();
+	noInterrupts();
+	// without ticks for a while the phase is lost as well
+	if (_aligned && error < 500) {
+		unsigned long elapsed = now - _anchor;
+		long offset = (long)(timestamp - (_seconds + elapsed / 1000));
+		unsigned long phase = elapsed % 1000;
+		// close to the seconds edge the RTC and millis() may differ by one second
+		if ((offset == 1 && phase + error >= 1000) || (offset == -1 && phase < error))
+			offset = 0;
+		_seconds += offset;
+	} else {
+		_seconds = timestamp;
+		_anchor = now;
+		_aligned = false;
+	}
+	interrupts();
+	_lastSync = now;
+}
+
+/**
+ * Call on every 1 Hz tick (falling edge of SQW in DS1337_TICK_EVERY_SECOND mode),
+ * e.g. from the interrupt routine: the tick is the start of a second
+ */
+void DS1337Clock::tick() {
+	unsigned long now = millis();
+	if (_aligned)
+		_seconds += (now - _anchor + 500) / 1000;
+	else
+		_seconds++;
+	_anchor = now;
+	_aligned = true;
+}
+
+/**
+ * Set the interval to read the RTC again (ms, 0 = never)
+ */
+void DS1337Clock::setSyncInterval(unsigned long interval) {
+	_interval = interval;
+}
+
+/**
+ * Set the tolerance of the MCU clock (ppm), used for the error bound
+ */
+void DS1337Clock::setTolerance(unsigned long ppm) {
+	_tolerance = ppm;
+}
+
+/**
+ * Check, if the clock is aligned to the start of a second by a tick
+ */
+boolean DS1337Clock::isAligned() {
+	return _aligned;
+}
+
+/**
+ * Get unix timestamp without bus access (except for a sync after the sync interval)
+ */
+unsigned long DS1337Clock::getTimestamp() {
+	unsigned int milliseconds;
+	return getTimestamp(milliseconds);
+}
+
+/**
+ * Get unix timestamp and milliseconds of the current second
+ * (never less than the previous result, also after a sync)
+ */
+unsigned long DS1337Clock::getTimestamp(unsigned int &milliseconds) {
+	if (_interval > 0 && millis() - _lastSync >= _interval)
+		sync();
+	noInterrupts();
+	unsigned long seconds = _seconds;
+	unsigned long anchor = _anchor;
+	interrupts();
+	unsigned long elapsed = millis() - anchor;
+	seconds += elapsed / 1000;
+	milliseconds = elapsed % 1000;
+	if (seconds < _lastSeconds || (seconds == _lastSeconds && milliseconds < _lastMilliseconds)) {
+		seconds = _lastSeconds;
+		milliseconds = _lastMilliseconds;
+	}
+	_lastSeconds = seconds;
+	_lastMilliseconds = milliseconds;
+	return seconds;
+}
+
+/**
+ * Get the bound of the error of getTimestamp (ms): the unknown phase
+ * until the first tick and the tolerance of millis() since the last tick/sync
+ */
+unsigned long DS1337Clock::getError() {
+	noInterrupts();
+	unsigned long anchor = _anchor;
+	boolean aligned = _aligned;
+	interrupts();
+	unsigned long elapsed = millis() - anchor;
+	unsigned long error = 1 + elapsed / 1000 * _tolerance / 1000;
+	if (!aligned)
+		error += 1000;
+	return error;
+}
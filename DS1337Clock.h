@@ -0,0 +1,63 @@
+/**
+
+DS1337Clock.h
+
+Copyright by Christian Paul, 2014
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+ */
+#ifndef DS1337Clock_h
+#define DS1337Clock_h
+
+// includes
+#include <Arduino.h>
+#include "DS1337.h"
+
+// default interval to read the RTC again (ms)
+#define DS1337_CLOCK_SYNC_INTERVAL	3600000UL
+// default tolerance of the MCU clock (ppm, ceramic resonator)
+#define DS1337_CLOCK_TOLERANCE		5000UL
+
+// class definition of a software clock interpolating the RTC with millis()
+class DS1337Clock {
+	public:
+		DS1337Clock(DS1337 &rtc);
+		void begin();
+		void sync();
+		void tick();
+		void setSyncInterval(unsigned long interval);
+		void setTolerance(unsigned long ppm);
+		boolean isAligned();
+		unsigned long getTimestamp();
+		unsigned long getTimestamp(unsigned int &milliseconds);
+		unsigned long getError();
+	private:
+		DS1337 *_rtc;
+		volatile unsigned long _seconds;
+		volatile unsigned long _anchor;
+		volatile boolean _aligned;
+		unsigned long _lastSync;
+		unsigned long _lastSeconds;
+		unsigned int _lastMilliseconds;
+		unsigned long _interval;
+		unsigned long _tolerance;
+};
+
+#endif
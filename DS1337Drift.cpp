@@ -0,0 +1,152 @@
+/**
+
+DS1337Drift.cpp
+
+Copyright by Christian Paul, 2014
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+ */
+#include "DS1337Drift.h"
+
+/**
+ * Constructor of class DS1337Drift (no correction)
+ */
+DS1337Drift::DS1337Drift(DS1337 &rtc) {
+	_rtc = &rtc;
+	_coefficients.origin = 0;
+	_coefficients.offset = 0;
+	_coefficients.drift = 0;
+	clear();
+}
+
+/**
+ * Add a pair of RTC time and reference time (e.g. of a network sync,
+ * milliseconds of the reference time optional). The coefficients are
+ * fitted again.
+ */
+void DS1337Drift::addSample(unsigned long rtc, unsigned long reference, unsigned int milliseconds) {
+	byte i = (_first + _count) % DS1337_DRIFT_SAMPLES;
+	if (_count == DS1337_DRIFT_SAMPLES)
+		_first = (_first + 1) % DS1337_DRIFT_SAMPLES;
+	else
+		_count++;
+	_samples[i].rtc = rtc;
+	_samples[i].offset = (long)(reference - rtc) * 1000L + milliseconds;
+	fit();
+}
+
+/**
+ * Number of pairs
+ */
+byte DS1337Drift::count() {
+	return _count;
+}
+
+/**
+ * Drop all pairs (e.g. after the RTC was set), the coefficients are kept
+ */
+void DS1337Drift::clear() {
+	_first = 0;
+	_count = 0;
+}
+
+/**
+ * Least squares fit of offset and drift (integer only)
+ */
+void DS1337Drift::fit() {
+	DS1337DriftSample &last = _samples[(_first + _count - 1) % DS1337_DRIFT_SAMPLES];
+	if (_count < 2) {
+		// offset only, keep the drift
+		_coefficients.origin = last.rtc;
+		_coefficients.offset = last.offset;
+		return;
+	}
+	// means relative to the newest pair (keeps the sums small)
+	int64_t sx = 0, sy = 0;
+	for (byte i=0; i<_count; i++) {
+		DS1337DriftSample &s = _samples[(_first + i) % DS1337_DRIFT_SAMPLES];
+		sx += (long)(s.rtc - last.rtc);
+		sy += s.offset;
+	}
+	int64_t sxx = 0, sxy = 0;
+	for (byte i=0; i<_count; i++) {
+		DS1337DriftSample &s = _samples[(_first + i) % DS1337_DRIFT_SAMPLES];
+		int64_t x = (int64_t)(long)(s.rtc - last.rtc) * _count - sx;
+		int64_t y = (int64_t)s.offset * _count - sy;
+		sxx += x * x / _count;
+		sxy += x * y / _count;
+	}
+	if (sxx == 0)
+		return;
+	// slope in ms per s scaled to ppb (long division in steps of 1000 to avoid overflow)
+	int64_t drift = sxy / sxx;
+	int64_t r = sxy % sxx;
+	for (byte i=0; i<2; i++) {
+		r *= 1000;
+		drift = drift * 1000 + r / sxx;
+		r %= sxx;
+	}
+	// offset of the fitted line at the newest pair
+	_coefficients.origin = last.rtc;
+	_coefficients.offset = (long)((sy - drift * sx / 1000000) / _count);
+	_coefficients.drift = (long)drift;
+}
+
+/**
+ * Get/Set the fitted coefficients (e.g. to persist them in EEPROM)
+ */
+void DS1337Drift::getCoefficients(DS1337DriftCoefficients &coefficients) {
+	coefficients = _coefficients;
+}
+
+void DS1337Drift::setCoefficients(const DS1337DriftCoefficients &coefficients) {
+	_coefficients = coefficients;
+}
+
+/**
+ * Get the drift (ppb, positive if the RTC is slow)
+ */
+long DS1337Drift::getDrift() {
+	return _coefficients.drift;
+}
+
+/**
+ * Get the correction of a RTC time (ms)
+ */
+long DS1337Drift::getOffset(unsigned long timestamp) {
+	long elapsed = (long)(timestamp - _coefficients.origin);
+	// s * ppb / 10^6 = ms
+	return _coefficients.offset + (long)((int64_t)elapsed * _coefficients.drift / 1000000);
+}
+
+/**
+ * Correct a RTC time (unix timestamp, rounded to seconds)
+ */
+unsigned long DS1337Drift::correct(unsigned long timestamp) {
+	long offset = getOffset(timestamp);
+	return timestamp + (offset + (offset < 0 ? -500 : 500)) / 1000;
+}
+
+/**
+ * Get the corrected current time of the RTC (unix timestamp)
+ */
+unsigned long DS1337Drift::correctedTimestamp() {
+	return correct(_rtc->getTimestamp());
+}
@@ -0,0 +1,71 @@
+/**
+
+DS1337Drift.h
+
+Copyright by Christian Paul, 2014
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+ */
+#ifndef DS1337Drift_h
+#define DS1337Drift_h
+
+// includes
+#include <Arduino.h>
+#include "DS1337.h"
+
+// number of (RTC, reference) pairs used for the fit
+#define DS1337_DRIFT_SAMPLES	8
+
+// fitted correction: reference = RTC + offset + drift * (RTC - origin)
+struct DS1337DriftCoefficients {
+	unsigned long origin;	// RTC unix timestamp
+	long offset;			// ms at origin
+	long drift;				// ppb, positive if the RTC is slow
+};
+
+// pair of RTC and reference time
+struct DS1337DriftSample {
+	unsigned long rtc;
+	long offset;			// reference - RTC (ms)
+};
+
+// class definition of a drift estimator correcting the RTC time
+class DS1337Drift {
+	public:
+		DS1337Drift(DS1337 &rtc);
+		void addSample(unsigned long rtc, unsigned long reference, unsigned int milliseconds = 0);
+		byte count();
+		void clear();
+		void getCoefficients(DS1337DriftCoefficients &coefficients);
+		void setCoefficients(const DS1337DriftCoefficients &coefficients);
+		long getDrift();
+		long getOffset(unsigned long timestamp);
+		unsigned long correct(unsigned long timestamp);
+		unsigned long correctedTimestamp();
+	private:
+		void fit();
+		DS1337 *_rtc;
+		DS1337DriftSample _samples[DS1337_DRIFT_SAMPLES];
+		byte _first;
+		byte _count;
+		DS1337DriftCoefficients _coefficients;
+};
+
+#endif
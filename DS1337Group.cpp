@@ -0,0 +1,197 @@
+/**
+
+DS1337Group.cpp
+
+Copyright by Christian Paul, 2014
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+ */
+#include "DS1337Group.h"
+
+/**
+ * Constructor of class DS1337Group
+ */
+DS1337Group::DS1337Group() {
+	_count = 0;
+	_next = 0;
+	_agree = 0;
+	_consensus = 0;
+	_tolerance = DS1337_GROUP_TOLERANCE;
+}
+
+/**
+ * Add a RTC (with its own transport and address), returns its index or -1 if full
+ */
+int DS1337Group::add(DS1337 &rtc) {
+	if (_count >= DS1337_GROUP_SIZE)
+		return -1;
+	_rtc[_count] = &rtc;
+	_timestamp[_count] = 0;
+	_millis[_count] = 0;
+	_busMicros[_count] = 0;
+	_state[_count] = 0;
+	return _count++;
+}
+
+/**
+ * Number of RTCs
+ */
+byte DS1337Group::count() {
+	return _count;
+}
+
+/**
+ * Read the next RTC with one snapshot, returns true after a full cycle
+ * (then the consensus is updated)
+ */
+boolean DS1337Group::poll() {
+	if (_count == 0)
+		return false;
+	DS1337 *rtc = _rtc[_next];
+	unsigned long bus = rtc->getStats().busMicros;
+	DS1337Snapshot snapshot = rtc->snapshot();
+	_millis[_next] = millis();
+	// measured, if the library counts (DS1337_STATS), else the bus cost model
+	bus = rtc->getStats().busMicros - bus;
+	_busMicros[_next] = bus > 0 ? bus : rtc->getTransport()->getReadMicros(rtc->getRegisterCount());
+	// OSF tells an oscillator stop on both chips (EOSC only stops the DS3231 on battery)
+	Date date = snapshot.getDate();
+	if (snapshot.isValid() && !snapshot.hasStopped() && date.getMonth() >= 1 && date.getMonth() <= 12 && date.getDay() >= 1) {
+		_timestamp[_next] = snapshot.getTimestamp();
+		_state[_next] = DS1337_GROUP_VALID;
+	}
+	else
+		_state[_next] = 0;
+	_next++;
+	if (_next < _count)
+		return false;
+	_next = 0;
+	vote();
+	return true;
+}
+
+/**
+ * Read all RTCs (one full cycle)
+ */
+void DS1337Group::update() {
+	while (!poll() && _count > 0);
+}
+
+/**
+ * Set the max. deviation (seconds) from the consensus time
+ */
+void DS1337Group::setTolerance(unsigned long tolerance) {
+	_tolerance = tolerance;
+}
+
+/**
+ * Compute the consensus time (median of the valid RTCs) and mark the outliers
+ */
+void DS1337Group::vote() {
+	unsigned long now = millis();
+	unsigned long sorted[DS1337_GROUP_SIZE];
+	byte n = 0;
+	// timestamps at the end of the cycle
+	for (byte i=0; i<_count; i++) {
+		if (!(_state[i] & DS1337_GROUP_VALID))
+			continue;
+		_timestamp[i] += (now - _millis[i] + 500) / 1000;
+		_millis[i] = now;
+		// insertion sort
+		byte j = n++;
+		while (j > 0 && sorted[j-1] > _timestamp[i]) {
+			sorted[j] = sorted[j-1];
+			j--;
+		}
+		sorted[j] = _timestamp[i];
+	}
+	_agree = 0;
+	if (n == 0) {
+		for (byte i=0; i<_count; i++)
+			_state[i] = 0;
+		return;
+	}
+	_consensus = sorted[(n - 1) / 2];
+	for (byte i=0; i<_count; i++) {
+		if (!(_state[i] & DS1337_GROUP_VALID))
+			continue;
+		unsigned long deviation = _timestamp[i] > _consensus ? _timestamp[i] - _consensus : _consensus - _timestamp[i];
+		if (deviation > _tolerance)
+			_state[i] |= DS1337_GROUP_OUTLIER;
+		else
+			_agree++;
+	}
+}
+
+/**
+ * Check, if more than half of all RTCs agree on the consensus time
+ */
+boolean DS1337Group::hasConsensus() {
+	return _count > 0 && 2 * _agree > _count;
+}
+
+/**
+ * Get the consensus time of the last cycle (unix timestamp)
+ */
+unsigned long DS1337Group::getTimestamp() {
+	return _consensus;
+}
+
+/**
+ * Get the time of a RTC in the last cycle (unix timestamp)
+ */
+unsigned long DS1337Group::getTimestamp(byte index) {
+	return index < _count ? _timestamp[index] : 0;
+}
+
+/**
+ * Get the deviation of a RTC from the consensus time (seconds)
+ */
+long DS1337Group::getOffset(byte index) {
+	return index < _count ? (long)(_timestamp[index] - _consensus) : 0;
+}
+
+/**
+ * Check, if the last read of the RTC was complete and without oscillator stop
+ */
+boolean DS1337Group::isValid(byte index) {
+	return index < _count && (_state[index] & DS1337_GROUP_VALID);
+}
+
+/**
+ * Check, if a valid RTC deviates more than the tolerance from the consensus time
+ */
+boolean DS1337Group::isOutlier(byte index) {
+	return index < _count && (_state[index] & DS1337_GROUP_OUTLIER);
+}
+
+/**
+ * Number of invalid RTCs and outliers
+ */
+byte DS1337Group::getOutliers() {
+	return _count - _agree;
+}
+
+/**
+ * Bus time (microseconds) of the last read of a RTC
+ */
+unsigned long DS1337Group::getBusMicros(byte index) {
+	return index < _count ? _busMicros[index] : 0;
+}
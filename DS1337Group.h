@@ -0,0 +1,74 @@
+/**
+
+DS1337Group.h
+
+Copyright by Christian Paul, 2014
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+ */
+#ifndef DS1337Group_h
+#define DS1337Group_h
+
+// includes
+#include <Arduino.h>
+#include "DS1337.h"
+
+// max. number of RTCs in a group
+#define DS1337_GROUP_SIZE		8
+
+// max. deviation (seconds) from the consensus time before a RTC is an outlier
+#define DS1337_GROUP_TOLERANCE	2
+
+// state of a RTC in the group
+#define DS1337_GROUP_VALID		0x01
+#define DS1337_GROUP_OUTLIER	0x02
+
+// class definition of a group of redundant RTCs polled round-robin
+class DS1337Group {
+	public:
+		DS1337Group();
+		int add(DS1337 &rtc);
+		byte count();
+		boolean poll();
+		void update();
+		void setTolerance(unsigned long tolerance);
+		boolean hasConsensus();
+		unsigned long getTimestamp();
+		unsigned long getTimestamp(byte index);
+		long getOffset(byte index);
+		boolean isValid(byte index);
+		boolean isOutlier(byte index);
+		byte getOutliers();
+		unsigned long getBusMicros(byte index);
+	private:
+		void vote();
+		DS1337 *_rtc[DS1337_GROUP_SIZE];
+		unsigned long _timestamp[DS1337_GROUP_SIZE];
+		unsigned long _millis[DS1337_GROUP_SIZE];
+		unsigned long _busMicros[DS1337_GROUP_SIZE];
+		byte _state[DS1337_GROUP_SIZE];
+		byte _count;
+		byte _next;
+		byte _agree;
+		unsigned long _consensus;
+		unsigned long _tolerance;
+};
+
+#endif
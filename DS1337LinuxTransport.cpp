@@ -0,0 +1,169 @@
+/**
+
+DS1337LinuxTransport.cpp
+
+Copyright by Christian Paul, 2014
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+ */
+#if defined(__linux__)
+
+#include "DS1337LinuxTransport.h"
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <linux/i2c.h>
+#include <linux/i2c-dev.h>
+
+/**
+ * Constructor of class DS1337LinuxTransport, the device is opened by begin()
+ */
+DS1337LinuxTransport::DS1337LinuxTransport(const char *device) {
+	_device = device;
+	_fd = -1;
+	_owner = true;
+}
+
+/**
+ * Constructor of class DS1337LinuxTransport with an already opened file descriptor
+ * (not closed by the transport)
+ */
+DS1337LinuxTransport::DS1337LinuxTransport(int fd) {
+	_device = NULL;
+	_fd = fd;
+	_owner = false;
+}
+
+/**
+ * Destructor, closes the device if opened by begin()
+ */
+DS1337LinuxTransport::~DS1337LinuxTransport() {
+	end();
+}
+
+/**
+ * Open the i2c-dev device
+ */
+void DS1337LinuxTransport::begin() {
+	if (_fd < 0 && _device != NULL)
+		_fd = open(_device, O_RDWR);
+}
+
+/**
+ * Close the i2c-dev device
+ */
+void DS1337LinuxTransport::end() {
+	if (_owner && _fd >= 0) {
+		close(_fd);
+		_fd = -1;
+	}
+}
+
+/**
+ * Get the file descriptor (-1, if not open)
+ */
+int DS1337LinuxTransport::getFd() {
+	return _fd;
+}
+
+/**
+ * Issue messages as one combined transaction (repeated start between them),
+ * returns the number of messages transferred or -1
+ */
+int DS1337LinuxTransport::transfer(struct i2c_msg *messages, int count) {
+	struct i2c_rdwr_ioctl_data data;
+	data.msgs = messages;
+	data.nmsgs = count;
+	return ioctl(_fd, I2C_RDWR, &data);
+}
+
+/**
+ * Read registers: register pointer write and data read in one transaction
+ */
+byte DS1337LinuxTransport::read(byte address, byte startRegister, byte *data, byte count) {
+	struct i2c_msg messages[2];
+	messages[0].addr = address;
+	messages[0].flags = 0;
+	messages[0].len = 1;
+	messages[0].buf = &startRegister;
+	messages[1].addr = address;
+	messages[1].flags = I2C_M_RD;
+	messages[1].len = count;
+	messages[1].buf = data;
+	if (transfer(messages, 2) != 2)
+		return 0;
+	return count;
+}
+
+/**
+ * Write registers: register pointer followed by data in one message
+ */
+byte DS1337LinuxTransport::write(byte address, byte startRegister, const byte *data, byte count) {
+	byte buffer[256];
+	if (count > sizeof(buffer) - 1)
+		count = sizeof(buffer) - 1;
+	buffer[0] = startRegister;
+	for (byte i=0; i<count; i++) {
+		buffer[i+1] = data[i];
+	}
+	struct i2c_msg message;
+	message.addr = address;
+	message.flags = 0;
+	message.len = count + 1;
+	message.buf = buffer;
+	if (transfer(&message, 1) != 1)
+		return 0;
+	return count;
+}
+
+/**
+ * Set the register pointer only
+ */
+byte DS1337LinuxTransport::point(byte address, byte startRegister) {
+	struct i2c_msg message;
+	message.addr = address;
+	message.flags = 0;
+	message.len = 1;
+	message.buf = &startRegister;
+	return transfer(&message, 1) == 1;
+}
+
+/**
+ * Read registers from the current register pointer on
+ */
+byte DS1337LinuxTransport::receive(byte address, byte *data, byte count) {
+	struct i2c_msg message;
+	message.addr = address;
+	message.flags = I2C_M_RD;
+	message.len = count;
+	message.buf = data;
+	if (transfer(&message, 1) != 1)
+		return 0;
+	return count;
+}
+
+/**
+ * A register read is one combined transaction (repeated start)
+ */
+byte DS1337LinuxTransport::getReadTransactions() {
+	return 1;
+}
+
+#endif
@@ -0,0 +1,64 @@
+/**
+
+DS1337LinuxTransport.h
+
+Copyright by Christian Paul, 2014
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+ */
+#ifndef DS1337LinuxTransport_h
+#define DS1337LinuxTransport_h
+
+#if defined(__linux__)
+
+// includes
+#include "DS1337Transport.h"
+
+// default i2c-dev device
+#define DS1337_LINUX_DEVICE  "/dev/i2c-1"
+
+// forward declaration of the i2c-dev message
+struct i2c_msg;
+
+// class definition of the transport over Linux i2c-dev (combined I2C_RDWR transactions)
+class DS1337LinuxTransport : public DS1337Transport {
+	public:
+		DS1337LinuxTransport(const char *device = DS1337_LINUX_DEVICE);
+		DS1337LinuxTransport(int fd);
+		virtual ~DS1337LinuxTransport();
+		void begin();
+		void end();
+		int getFd();
+		byte read(byte address, byte startRegister, byte *data, byte count);
+		byte write(byte address, byte startRegister, const byte *data, byte count);
+		byte point(byte address, byte startRegister);
+		byte receive(byte address, byte *data, byte count);
+		byte getReadTransactions();
+	protected:
+		virtual int transfer(struct i2c_msg *messages, int count);
+	private:
+		const char *_device;
+		int _fd;
+		boolean _owner;
+};
+
+#endif
+
+#endif
@@ -0,0 +1,216 @@
+/**
+
+DS1337Log.cpp
+
+Copyright by Christian Paul, 2014
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+ */
+#include "DS1337Log.h"
+
+/**
+ * Constructor of class DS1337LogWriter (e.g. on a SD card file)
+ */
+DS1337LogWriter::DS1337LogWriter(Print &out) {
+	_out = &out;
+	_last = 0;
+	_interval = DS1337_LOG_SYNC_INTERVAL;
+	_sinceSync = 0;
+	_synced = false;
+	_records = 0;
+	_bytes = 0;
+}
+
+/**
+ * Set the number of records between two absolute records
+ * (a reader knowing the offset of an absolute record can start there)
+ */
+void DS1337LogWriter::setSyncInterval(unsigned int interval) {
+	_interval = interval;
+}
+
+/**
+ * Write the next record with an absolute timestamp (e.g. after opening a new file)
+ */
+void DS1337LogWriter::sync() {
+	_synced = false;
+}
+
+/**
+ * Encode a varint, returns its length
+ */
+byte DS1337LogWriter::encodeVarint(unsigned long value, byte *out) {
+	byte n = 0;
+	while (value >= 0x80) {
+		out[n++] = (value & 0x7F) | 0x80;
+		value >>= 7;
+	}
+	out[n++] = value;
+	return n;
+}
+
+/**
+ * Write a record, returns the number of bytes written. After a partial write
+ * the record isn't counted and the next record is absolute.
+ */
+size_t DS1337LogWriter::write(unsigned long timestamp, const byte *data, byte length) {
+	byte header[DS1337_LOG_HEADER_SIZE + 1];
+	byte n = 0;
+	// absolute, if out of sync, time went back or the delta is too large for a short varint
+	if (!_synced || _sinceSync >= _interval || timestamp < _last || timestamp - _last >= 0x10000000UL) {
+		header[n++] = DS1337_LOG_ABSOLUTE;
+		header[n++] = timestamp >> 24;
+		header[n++] = timestamp >> 16;
+		header[n++] = timestamp >> 8;
+		header[n++] = timestamp;
+		_synced = true;
+		_sinceSync = 0;
+	}
+	else
+		n += encodeVarint((timestamp - _last) << 1, header + n);
+	n += encodeVarint(length, header + n);
+	size_t written = _out->write(header, n);
+	if (length > 0 && written == n)
+		written += _out->write(data, length);
+	_bytes += written;
+	if (written != (size_t)n + length) {
+		_synced = false;
+		return written;
+	}
+	_last = timestamp;
+	_sinceSync++;
+	_records++;
+	return written;
+}
+
+/**
+ * Write a record at the current time of the RTC
+ */
+size_t DS1337LogWriter::write(DS1337 &rtc, const byte *data, byte length) {
+	return write(rtc.getTimestamp(), data, length);
+}
+
+/**
+ * Number of records and bytes written
+ */
+unsigned long DS1337LogWriter::getRecords() {
+	return _records;
+}
+
+unsigned long DS1337LogWriter::getBytes() {
+	return _bytes;
+}
+
+/**
+ * Constructor of class DS1337LogReader
+ */
+DS1337LogReader::DS1337LogReader(const byte *buffer, size_t size) {
+	_buffer = buffer;
+	_size = size;
+	rewind();
+}
+
+/**
+ * Start again at the beginning of the buffer
+ */
+void DS1337LogReader::rewind() {
+	_position = 0;
+	_last = 0;
+	_synced = false;
+	_error = false;
+}
+
+/**
+ * Decode a varint, false if truncated or too long
+ */
+boolean DS1337LogReader::decodeVarint(unsigned long &value) {
+	value = 0;
+	for (byte shift=0; shift<32; shift+=7) {
+		if (_position >= _size)
+			return false;
+		byte b = _buffer[_position++];
+		value |= (unsigned long)(b & 0x7F) << shift;
+		if (!(b & 0x80))
+			return true;
+	}
+	return false;
+}
+
+/**
+ * Decode the next record, false at the end of the buffer or on an error
+ * (a truncated record or a delta record before the first absolute record)
+ */
+boolean DS1337LogReader::next(DS1337LogRecord &record) {
+	if (_error || _position >= _size)
+		return false;
+	size_t start = _position;
+	unsigned long header;
+	if (_buffer[_position] == DS1337_LOG_ABSOLUTE) {
+		if (_size - _position < 5) {
+			_error = true;
+			return false;
+		}
+		const byte *b = _buffer + _position + 1;
+		_last = ((unsigned long)b[0] << 24) | ((unsigned long)b[1] << 16) | ((unsigned long)b[2] << 8) | b[3];
+		_position += 5;
+		_synced = true;
+	}
+	else if (!decodeVarint(header) || !_synced) {
+		_error = true;
+		_position = start;
+		return false;
+	}
+	else
+		_last += header >> 1;
+	unsigned long length;
+	if (!decodeVarint(length) || length > 0xFF || length > _size - _position) {
+		_error = true;
+		_position = start;
+		return false;
+	}
+	record.timestamp = _last;
+	record.data = _buffer + _position;
+	record.length = length;
+	_position += length;
+	return true;
+}
+
+/**
+ * Check, if decoding stopped on an error
+ */
+boolean DS1337LogReader::hasError() {
+	return _error;
+}
+
+/**
+ * Position of the next record in the buffer
+ */
+size_t DS1337LogReader::getPosition() {
+	return _position;
+}
+
+/**
+ * Date of a timestamp
+ */
+Date DS1337LogReader::toDate(unsigned long timestamp) {
+	int year, month, day, hour, minutes, seconds;
+	DS1337::getTime(timestamp, year, month, day, hour, minutes, seconds);
+	return Date(year, month, day, hour, minutes, seconds);
+}
@@ -0,0 +1,91 @@
+/**
+
+DS1337Log.h
+
+Copyright by Christian Paul, 2014
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+ */
+#ifndef DS1337Log_h
+#define DS1337Log_h
+
+// includes
+#include <Arduino.h>
+#include "DS1337.h"
+
+// Record format (varints are 7 bits per byte, least significant first):
+//   delta record:    varint (delta << 1), varint length, payload
+//   absolute record: 0x01, timestamp (4 bytes, big endian), varint length, payload
+// The tag is only unique at the start of a record (0x01 may appear in varints and
+// payload), so a log is decoded from its beginning or from a known record offset.
+#define DS1337_LOG_ABSOLUTE			0x01
+// records between two absolute records
+#define DS1337_LOG_SYNC_INTERVAL	64
+// max. size of a record header (absolute tag, timestamp, length)
+#define DS1337_LOG_HEADER_SIZE		7
+
+// decoded record (data points into the buffer of the reader)
+struct DS1337LogRecord {
+	unsigned long timestamp;
+	const byte *data;
+	byte length;
+};
+
+// class definition of the binary log writer
+class DS1337LogWriter {
+	public:
+		DS1337LogWriter(Print &out);
+		void setSyncInterval(unsigned int interval);
+		void sync();
+		size_t write(unsigned long timestamp, const byte *data, byte length);
+		size_t write(DS1337 &rtc, const byte *data, byte length);
+		unsigned long getRecords();
+		unsigned long getBytes();
+	private:
+		static byte encodeVarint(unsigned long value, byte *out);
+		Print *_out;
+		unsigned long _last;
+		unsigned int _interval;
+		unsigned int _sinceSync;
+		boolean _synced;
+		unsigned long _records;
+		unsigned long _bytes;
+};
+
+// class definition of the binary log reader (over a buffer, e.g. a memory mapped file)
+class DS1337LogReader {
+	public:
+		DS1337LogReader(const byte *buffer, size_t size);
+		boolean next(DS1337LogRecord &record);
+		boolean hasError();
+		size_t getPosition();
+		void rewind();
+		static Date toDate(unsigned long timestamp);
+	private:
+		boolean decodeVarint(unsigned long &value);
+		const byte *_buffer;
+		size_t _size;
+		size_t _position;
+		unsigned long _last;
+		boolean _synced;
+		boolean _error;
+};
+
+#endif
@@ -0,0 +1,208 @@
+/**
+
+DS1337PackedDate.cpp
+
+Copyright by Christian Paul, 2014
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+ */
+#include "DS1337PackedDate.h"
+
+/**
+ * Constructor of class PackedDate (2000-00-00 00:00:00)
+ */
+PackedDate::PackedDate() {
+	_value = 0;
+}
+
+/**
+ * Constructor of class PackedDate with a packed value
+ */
+PackedDate::PackedDate(uint32_t value) {
+	_value = value;
+}
+
+/**
+ * Constructor of class PackedDate with a date (year 0..63, later dates are
+ * clamped to 2063-12-31 23:59:59, earlier ones to 2000-00-00 00:00:00)
+ */
+PackedDate::PackedDate(Date date) {
+	*this = PackedDate(date.getYear(), date.getMonth(), date.getDay(), date.getHour(), date.getMinutes(), date.getSeconds());
+}
+
+/**
+ * Constructor of class PackedDate with date and time (year 0..63, later dates are
+ * clamped to 2063-12-31 23:59:59, earlier ones to 2000-00-00 00:00:00, so the
+ * order is kept)
+ */
+PackedDate::PackedDate(int year, int month, int day, int hour, int minutes, int seconds) {
+	if (year >= DS1337_PACKED_YEARS) {
+		_value = DS1337_PACKED_MAX;
+		return;
+	}
+	if (year < 0) {
+		_value = 0;
+		return;
+	}
+	_value = ((uint32_t)(year & 0x3F) << DS1337_PACKED_YEAR_SHIFT)
+		| ((uint32_t)(month & 0x0F) << DS1337_PACKED_MONTH_SHIFT)
+		| ((uint32_t)(day & 0x1F) << DS1337_PACKED_DAY_SHIFT)
+		| ((uint32_t)(hour & 0x1F) << DS1337_PACKED_HOUR_SHIFT)
+		| ((uint32_t)(minutes & 0x3F) << DS1337_PACKED_MINUTES_SHIFT)
+		| (uint32_t)(seconds & 0x3F);
+}
+
+/**
+ * Packed date of a unix timestamp (clamped to 2063-12-31 23:59:59)
+ */
+PackedDate PackedDate::fromTimestamp(unsigned long timestamp) {
+	int year, month, day, hour, minutes, seconds;
+	DS1337::getTime(timestamp, year, month, day, hour, minutes, seconds);
+	return PackedDate(year, month, day, hour, minutes, seconds);
+}
+
+/**
+ * Get the packed value
+ */
+uint32_t PackedDate::getValue() const {
+	return _value;
+}
+
+/**
+ * Get the fields
+ */
+int PackedDate::getSeconds() const {
+	return _value & 0x3F;
+}
+
+int PackedDate::getMinutes() const {
+	return (_value >> DS1337_PACKED_MINUTES_SHIFT) & 0x3F;
+}
+
+int PackedDate::getHour() const {
+	return (_value >> DS1337_PACKED_HOUR_SHIFT) & 0x1F;
+}
+
+int PackedDate::getDay() const {
+	return (_value >> DS1337_PACKED_DAY_SHIFT) & 0x1F;
+}
+
+int PackedDate::getMonth() const {
+	return (_value >> DS1337_PACKED_MONTH_SHIFT) & 0x0F;
+}
+
+int PackedDate::getYear() const {
+	return _value >> DS1337_PACKED_YEAR_SHIFT;
+}
+
+/**
+ * Unpack to a date
+ */
+Date PackedDate::toDate() const {
+	return Date(getYear(), getMonth(), getDay(), getHour(), getMinutes(), getSeconds());
+}
+
+/**
+ * Get unix timestamp
+ */
+unsigned long PackedDate::getTimestamp() const {
+	return DS1337::getTimestamp(getYear(), getMonth(), getDay(), getHour(), getMinutes(), getSeconds());
+}
+
+/**
+ * Compare (the packed values are in time order)
+ */
+bool PackedDate::operator==(const PackedDate &other) const { return _value == other._value; }
+bool PackedDate::operator!=(const PackedDate &other) const { return _value != other._value; }
+bool PackedDate::operator<(const PackedDate &other) const { return _value < other._value; }
+bool PackedDate::operator>(const PackedDate &other) const { return _value > other._value; }
+bool PackedDate::operator<=(const PackedDate &other) const { return _value <= other._value; }
+bool PackedDate::operator>=(const PackedDate &other) const { return _value >= other._value; }
+
+/**
+ * Constructor of class PackedDate40 (2000-00-00 00:00:00.000)
+ */
+PackedDate40::PackedDate40() {
+	memset(_value, 0, sizeof(_value));
+}
+
+/**
+ * Constructor of class PackedDate40 with a packed date and 1/256 seconds
+ */
+PackedDate40::PackedDate40(PackedDate date, byte fraction) {
+	uint32_t value = date.getValue();
+	_value[0] = value >> 24;
+	_value[1] = value >> 16;
+	_value[2] = value >> 8;
+	_value[3] = value;
+	_value[4] = fraction;
+}
+
+/**
+ * Packed date of a unix timestamp with milliseconds (clamped to 2063-12-31 23:59:59)
+ */
+PackedDate40 PackedDate40::fromTimestamp(unsigned long timestamp, unsigned int milliseconds) {
+	return PackedDate40(PackedDate::fromTimestamp(timestamp), ((unsigned long)milliseconds << 8) / 1000);
+}
+
+/**
+ * Get the packed date without fraction
+ */
+PackedDate PackedDate40::getDate() const {
+	return PackedDate(((uint32_t)_value[0] << 24) | ((uint32_t)_value[1] << 16) | ((uint32_t)_value[2] << 8) | _value[3]);
+}
+
+/**
+ * Get the fraction of the second (1/256 seconds)
+ */
+byte PackedDate40::getFraction() const {
+	return _value[4];
+}
+
+/**
+ * Get the milliseconds (rounded down to the 1/256 seconds resolution)
+ */
+unsigned int PackedDate40::getMilliseconds() const {
+	return ((unsigned long)_value[4] * 1000) >> 8;
+}
+
+/**
+ * Unpack to a date (without fraction)
+ */
+Date PackedDate40::toDate() const {
+	return getDate().toDate();
+}
+
+/**
+ * Get unix timestamp (without fraction)
+ */
+unsigned long PackedDate40::getTimestamp() const {
+	return getDate().getTimestamp();
+}
+
+/**
+ * Compare (the bytes are in time order)
+ */
+bool PackedDate40::operator==(const PackedDate40 &other) const { return memcmp(_value, other._value, sizeof(_value)) == 0; }
+bool PackedDate40::operator!=(const PackedDate40 &other) const { return memcmp(_value, other._value, sizeof(_value)) != 0; }
+bool PackedDate40::operator<(const PackedDate40 &other) const { return memcmp(_value, other._value, sizeof(_value)) < 0; }
+bool PackedDate40::operator>(const PackedDate40 &other) const { return memcmp(_value, other._value, sizeof(_value)) > 0; }
+bool PackedDate40::operator<=(const PackedDate40 &other) const { return memcmp(_value, other._value, sizeof(_value)) <= 0; }
+bool PackedDate40::operator>=(const PackedDate40 &other) const { return memcmp(_value, other._value, sizeof(_value)) >= 0; }
@@ -0,0 +1,92 @@
+/**
+
+DS1337PackedDate.h
+
+Copyright by Christian Paul, 2014
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+ */
+#ifndef DS1337PackedDate_h
+#define DS1337PackedDate_h
+
+// includes
+#include <Arduino.h>
+#include "DS1337.h"
+
+// bit layout of a packed date (most significant first, so integer order is time order):
+// year (6 bits, 2000..2063) | month (4) | day (5) | hour (5) | minutes (6) | seconds (6)
+#define DS1337_PACKED_YEAR_SHIFT	26
+#define DS1337_PACKED_MONTH_SHIFT	22
+#define DS1337_PACKED_DAY_SHIFT		17
+#define DS1337_PACKED_HOUR_SHIFT	12
+#define DS1337_PACKED_MINUTES_SHIFT	6
+#define DS1337_PACKED_YEARS			64
+// latest packed date (2063-12-31 23:59:59), later dates are clamped to it
+#define DS1337_PACKED_MAX			0xFF3F7EFBUL
+
+// class definition of a date packed into 32 bits
+class PackedDate {
+	public:
+		PackedDate();
+		PackedDate(uint32_t value);
+		PackedDate(Date date);
+		PackedDate(int year, int month, int day, int hour, int minutes, int seconds);
+		static PackedDate fromTimestamp(unsigned long timestamp);
+		uint32_t getValue() const;
+		int getSeconds() const;
+		int getMinutes() const;
+		int getHour() const;
+		int getDay() const;
+		int getMonth() const;
+		int getYear() const;
+		Date toDate() const;
+		unsigned long getTimestamp() const;
+		bool operator==(const PackedDate &other) const;
+		bool operator!=(const PackedDate &other) const;
+		bool operator<(const PackedDate &other) const;
+		bool operator>(const PackedDate &other) const;
+		bool operator<=(const PackedDate &other) const;
+		bool operator>=(const PackedDate &other) const;
+	private:
+		uint32_t _value;
+};
+
+// class definition of a packed date with 1/256 seconds in 40 bits (big endian, so byte order is time order)
+class PackedDate40 {
+	public:
+		PackedDate40();
+		PackedDate40(PackedDate date, byte fraction = 0);
+		static PackedDate40 fromTimestamp(unsigned long timestamp, unsigned int milliseconds = 0);
+		PackedDate getDate() const;
+		byte getFraction() const;
+		unsigned int getMilliseconds() const;
+		Date toDate() const;
+		unsigned long getTimestamp() const;
+		bool operator==(const PackedDate40 &other) const;
+		bool operator!=(const PackedDate40 &other) const;
+		bool operator<(const PackedDate40 &other) const;
+		bool operator>(const PackedDate40 &other) const;
+		bool operator<=(const PackedDate40 &other) const;
+		bool operator>=(const PackedDate40 &other) const;
+	private:
+		byte _value[5];
+};
+
+#endif
@@ -0,0 +1,198 @@
+/**
+
+DS1337Scheduler.cpp
+
+Copyright by Christian Paul, 2014
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+ */
+#include "DS1337Scheduler.h"
+
+/**
+ * Constructor of class DS1337Scheduler
+ */
+DS1337Scheduler::DS1337Scheduler(DS1337 &rtc) {
+	_rtc = &rtc;
+	_count = 0;
+	_armed = 0;
+}
+
+/**
+ * Init: the alarm registers are cached, so re-arming is a single write
+ */
+void DS1337Scheduler::begin() {
+	_rtc->enableCache();
+	// fill the cache
+	_rtc->snapshot();
+	_rtc->disableAlarm();
+	_rtc->clearAlarm();
+	_count = 0;
+	_armed = 0;
+}
+
+/**
+ * Add an alarm at a unix timestamp (returns false, if the scheduler is full)
+ */
+boolean DS1337Scheduler::add(unsigned long timestamp, byte id) {
+	if (_count >= DS1337_SCHEDULER_SIZE)
+		return false;
+	_heap[_count].timestamp = timestamp;
+	_heap[_count].id = id;
+	_count++;
+	siftUp(_count - 1);
+	if (_heap[0].timestamp != _armed)
+		arm(_rtc->getTimestamp());
+	return true;
+}
+
+/**
+ * Remove all alarms with an id (returns false, if there is none).
+ * The other alarms are compacted in one pass, then the heap is rebuilt.
+ */
+boolean DS1337Scheduler::remove(byte id) {
+	byte n = 0;
+	for (byte i=0; i<_count; i++) {
+		if (_heap[i].id != id)
+			_heap[n++] = _heap[i];
+	}
+	if (n == _count)
+		return false;
+	_count = n;
+	for (int i=_count/2-1; i>=0; i--)
+		siftDown(i);
+	if (_count == 0 || _heap[0].timestamp != _armed)
+		arm(_rtc->getTimestamp());
+	return true;
+}
+
+/**
+ * Get the number of pending alarms
+ */
+byte DS1337Scheduler::count() {
+	return _count;
+}
+
+/**
+ * Get the next alarm (returns false, if there is none)
+ */
+boolean DS1337Scheduler::peek(DS1337Alarm &alarm) {
+	if (_count == 0)
+		return false;
+	alarm = _heap[0];
+	return true;
+}
+
+/**
+ * Call after the alarm interrupt: calls the handler for all due alarms,
+ * then programs the next alarm. Returns the number of due alarms.
+ */
+int DS1337Scheduler::process(void (*handler)(DS1337Alarm &alarm)) {
+	unsigned long now = _rtc->getTimestamp();
+	int due = 0;
+	while (_count > 0 && _heap[0].timestamp <= now) {
+		DS1337Alarm alarm = _heap[0];
+		_count--;
+		_heap[0] = _heap[_count];
+		siftDown(0);
+		if (handler != NULL)
+			handler(alarm);
+		due++;
+	}
+	arm(now);
+	return due;
+}
+
+/**
+ * Get the alarm mode with the fewest compared fields, which can't
+ * match before the timestamp
+ */
+int DS1337Scheduler::getAlarmMode(unsigned long now, unsigned long timestamp) {
+	unsigned long delta = timestamp - now;
+	if (timestamp <= now || delta < SECONDS_PER_MINUTE)
+		return DS1337_ALARM_ON_SECOND;
+	if (delta < SECONDS_PER_HOUR)
+		return DS1337_ALARM_ON_SECOND_MINUTE;
+	if (delta < SECONDS_PER_DAY)
+		return DS1337_ALARM_ON_SECOND_MINUTE_HOUR;
+	// may match in an earlier month, then process() arms again
+	return DS1337_ALARM_ON_SECOND_MINUTE_HOUR_DATE;
+}
+
+/**
+ * Program the earliest alarm into alarm 1 (alarm, mode and
+ * flag are written in one burst)
+ */
+void DS1337Scheduler::arm(unsigned long now) {
+	if (_count == 0) {
+		_rtc->disableAlarm();
+		_armed = 0;
+		return;
+	}
+	unsigned long timestamp = _heap[0].timestamp;
+	// already due: fire on the next second
+	if (timestamp <= now)
+		timestamp = now + 1;
+	int year, month, day, hour, minute, second;
+	DS1337::getTime(timestamp, year, month, day, hour, minute, second);
+	_rtc->beginTransaction();
+	_rtc->setAlarm(Date(year, month, day, hour, minute, second));
+	_rtc->setAlarmMode(getAlarmMode(now, timestamp));
+	_rtc->clearAlarm();
+	if (!_rtc->isAlarmEnabled())
+		_rtc->enableAlarm();
+	_rtc->commit(DS1337_MAX_REGISTERS);
+	_armed = _heap[0].timestamp;
+}
+
+/**
+ * Move an entry up to keep the min-heap order
+ */
+void DS1337Scheduler::siftUp(byte i) {
+	while (i > 0) {
+		byte parent = (i - 1) / 2;
+		if (_heap[parent].timestamp <= _heap[i].timestamp)
+			break;
+		DS1337Alarm a = _heap[parent];
+		_heap[parent] = _heap[i];
+		_heap[i] = a;
+		i = parent;
+	}
+}
+
+/**
+ * Move an entry down to keep the min-heap order
+ */
+void DS1337Scheduler::siftDown(byte i) {
+	while (true) {
+		byte smallest = i;
+		byte left = 2 * i + 1;
+		byte right = left + 1;
+		if (left < _count && _heap[left].timestamp < _heap[smallest].timestamp)
+			smallest = left;
+		if (right < _count && _heap[right].timestamp < _heap[smallest].timestamp)
+			smallest = right;
+		if (smallest == i)
+			break;
+		DS1337Alarm a = _heap[smallest];
+		_heap[smallest] = _heap[i];
+		_heap[i] = a;
+		i = smallest;
+	}
+}
@@ -0,0 +1,63 @@
+/**
+
+DS1337Scheduler.h
+
+Copyright by Christian Paul, 2014
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+ */
+#ifndef DS1337Scheduler_h
+#define DS1337Scheduler_h
+
+// includes
+#include <Arduino.h>
+#include "DS1337.h"
+
+// max. number of pending alarms
+#define DS1337_SCHEDULER_SIZE	16
+
+// scheduled alarm
+struct DS1337Alarm {
+	unsigned long timestamp;
+	byte id;
+};
+
+// class definition of a scheduler of many alarms on the hardware alarm 1
+class DS1337Scheduler {
+	public:
+		DS1337Scheduler(DS1337 &rtc);
+		void begin();
+		boolean add(unsigned long timestamp, byte id);
+		boolean remove(byte id);
+		byte count();
+		boolean peek(DS1337Alarm &alarm);
+		int process(void (*handler)(DS1337Alarm &alarm));
+		static int getAlarmMode(unsigned long now, unsigned long timestamp);
+	private:
+		void arm(unsigned long now);
+		void siftUp(byte i);
+		void siftDown(byte i);
+		DS1337 *_rtc;
+		DS1337Alarm _heap[DS1337_SCHEDULER_SIZE];
+		byte _count;
+		unsigned long _armed;
+};
+
+#endif
@@ -0,0 +1,284 @@
+/**
+
+DS1337Transport.cpp
+
+Copyright by Christian Paul, 2014
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+ */
+#include "DS1337Transport.h"
+#include "Wire.h"
+
+/**
+ * Default transport over the global Wire object
+ */
+DS1337WireTransport DS1337Wire(Wire);
+
+/**
+ * Constructor of class DS1337Transport
+ */
+DS1337Transport::DS1337Transport() {
+	_clock = DS1337_I2C_STANDARD_MODE;
+	_pointer = 0;
+}
+
+/**
+ * Init the bus (nothing to do by default)
+ */
+void DS1337Transport::begin() {
+}
+
+/**
+ * Set the register pointer (for reading in steps with receive)
+ */
+byte DS1337Transport::point(byte /* address */, byte startRegister) {
+	_pointer = startRegister;
+	return 1;
+}
+
+/**
+ * Read registers from the register pointer on (register pointer is incremented)
+ */
+byte DS1337Transport::receive(byte address, byte *data, byte count) {
+	byte n = read(address, _pointer, data, count);
+	_pointer += n;
+	return n;
+}
+
+/**
+ * Number of transactions of a register read: pointer write and data read
+ * (2, transports with a repeated start in between return 1)
+ */
+byte DS1337Transport::getReadTransactions() {
+	return 2;
+}
+
+/**
+ * Set/Get the bus clock (Hz), used for the bus cost model only
+ */
+void DS1337Transport::setClock(unsigned long clock) { _clock = clock; }
+unsigned long DS1337Transport::getClock() { return _clock; }
+
+/**
+ * Bus time of a register read (pointer write + data read): two starts (or a
+ * start and a repeated start), one stop per transaction
+ */
+unsigned long DS1337Transport::getReadMicros(byte count) {
+	unsigned long bits = 2UL * DS1337_I2C_START_BITS + (unsigned long)getReadTransactions() * DS1337_I2C_STOP_BITS + (3UL + count) * DS1337_I2C_BYTE_BITS;
+	return (bits * 1000000UL + _clock - 1) / _clock;
+}
+
+/**
+ * Bus time of a register write (address, pointer and data in one transaction)
+ */
+unsigned long DS1337Transport::getWriteMicros(byte count) {
+	return getBusMicros(1, 2 + count, _clock);
+}
+
+/**
+ * Bus time in microseconds of some transactions with a total of bytes
+ * (address and register pointer bytes included)
+ */
+unsigned long DS1337Transport::getBusMicros(int transactions, int bytes, unsigned long clock) {
+	unsigned long bits = (unsigned long)transactions * (DS1337_I2C_START_BITS + DS1337_I2C_STOP_BITS) + (unsigned long)bytes * DS1337_I2C_BYTE_BITS;
+	return (bits * 1000000UL + clock - 1) / clock;
+}
+
+/**
+ * Constructor of class DS1337WireTransport
+ */
+DS1337WireTransport::DS1337WireTransport(TwoWire &wire) {
+	_wire = &wire;
+}
+
+/**
+ * Init the Wire bus
+ */
+void DS1337WireTransport::begin() {
+	_wire->begin();
+}
+
+/**
+ * Read registers: set register pointer, then request data
+ */
+byte DS1337WireTransport::read(byte address, byte startRegister, byte *data, byte count) {
+	_wire->beginTransmission(address);
+	_wire->write(startRegister);
+	if (_wire->endTransmission() != 0)
+		return 0;
+	_wire->requestFrom(address, count);
+	byte n = 0;
+	while (_wire->available() > 0 && n < count) {
+		data[n] = (byte)_wire->read();
+		n++;
+	}
+	return n;
+}
+
+/**
+ * Set the register pointer only
+ */
+byte DS1337WireTransport::point(byte address, byte startRegister) {
+	_wire->beginTransmission(address);
+	_wire->write(startRegister);
+	return _wire->endTransmission() == 0;
+}
+
+/**
+ * Read registers from the current register pointer on
+ */
+byte DS1337WireTransport::receive(byte address, byte *data, byte count) {
+	_wire->requestFrom(address, count);
+	byte n = 0;
+	while (_wire->available() > 0 && n < count) {
+		data[n] = (byte)_wire->read();
+		n++;
+	}
+	return n;
+}
+
+/**
+ * Write registers: register pointer followed by data in one transaction
+ */
+byte DS1337WireTransport::write(byte address, byte startRegister, const byte *data, byte count) {
+	_wire->beginTransmission(address);
+	_wire->write(startRegister);
+	for (byte i=0; i<count; i++) {
+		_wire->write(data[i]);
+	}
+	if (_wire->endTransmission() != 0)
+		return 0;
+	return count;
+}
+
+/**
+ * Constructor of class DS1337Mux
+ */
+DS1337Mux::DS1337Mux(DS1337Transport &bus, byte address) {
+	_bus = &bus;
+	_address = address;
+	_channel = DS1337_MUX_NONE;
+	_selects = 0;
+}
+
+/**
+ * Select a channel, the control register is only written on a change
+ */
+boolean DS1337Mux::select(byte channel) {
+	if (channel >= DS1337_MUX_CHANNELS)
+		return false;
+	if (channel == _channel)
+		return true;
+	_selects++;
+	if (!_bus->point(_address, 1 << channel)) {
+		_channel = DS1337_MUX_NONE;
+		return false;
+	}
+	_channel = channel;
+	return true;
+}
+
+/**
+ * Disconnect all channels
+ */
+void DS1337Mux::deselect() {
+	_bus->point(_address, 0);
+	_channel = DS1337_MUX_NONE;
+}
+
+/**
+ * Get the selected channel (DS1337_MUX_NONE, if none)
+ */
+byte DS1337Mux::getChannel() {
+	return _channel;
+}
+
+/**
+ * Get the upstream bus
+ */
+DS1337Transport *DS1337Mux::getBus() {
+	return _bus;
+}
+
+/**
+ * Get the number of channel switches (each is one write transaction of one byte)
+ */
+unsigned long DS1337Mux::getSelects() {
+	return _selects;
+}
+
+/**
+ * Constructor of class DS1337MuxTransport
+ */
+DS1337MuxTransport::DS1337MuxTransport(DS1337Mux &mux, byte channel) {
+	_mux = &mux;
+	_channel = channel;
+	_clock = mux.getBus()->getClock();
+}
+
+/**
+ * Init the upstream bus
+ */
+void DS1337MuxTransport::begin() {
+	_mux->getBus()->begin();
+}
+
+/**
+ * Read registers behind the multiplexer
+ */
+byte DS1337MuxTransport::read(byte address, byte startRegister, byte *data, byte count) {
+	if (!_mux->select(_channel))
+		return 0;
+	return _mux->getBus()->read(address, startRegister, data, count);
+}
+
+/**
+ * Write registers behind the multiplexer
+ */
+byte DS1337MuxTransport::write(byte address, byte startRegister, const byte *data, byte count) {
+	if (!_mux->select(_channel))
+		return 0;
+	return _mux->getBus()->write(address, startRegister, data, count);
+}
+
+/**
+ * Set the register pointer behind the multiplexer
+ */
+byte DS1337MuxTransport::point(byte address, byte startRegister) {
+	if (!_mux->select(_channel))
+		return 0;
+	return _mux->getBus()->point(address, startRegister);
+}
+
+/**
+ * Read registers from the current register pointer on behind the multiplexer
+ */
+byte DS1337MuxTransport::receive(byte address, byte *data, byte count) {
+	if (!_mux->select(_channel))
+		return 0;
+	return _mux->getBus()->receive(address, data, count);
+}
+
+/**
+ * Number of transactions of a register read on the bus of the multiplexer
+ */
+byte DS1337MuxTransport::getReadTransactions() {
+	return _mux->getBus()->getReadTransactions();
+}
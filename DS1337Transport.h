@@ -0,0 +1,117 @@
+/**
+
+DS1337Transport.h
+
+Copyright by Christian Paul, 2014
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+ */
+#ifndef DS1337Transport_h
+#define DS1337Transport_h
+
+// includes
+#include <Arduino.h>
+
+// I2C bus clocks
+#define DS1337_I2C_STANDARD_MODE  100000UL
+#define DS1337_I2C_FAST_MODE      400000UL
+
+// I2C bus timing (in bit times)
+#define DS1337_I2C_START_BITS  1
+#define DS1337_I2C_STOP_BITS   1
+#define DS1337_I2C_BYTE_BITS   9
+
+// TCA9548A I2C multiplexer
+#define DS1337_TCA9548A_ID  0x70
+#define DS1337_MUX_CHANNELS 8
+#define DS1337_MUX_NONE     0xFF
+
+// forward declaration of the Arduino I2C class
+class TwoWire;
+
+// class definition of the register transport
+class DS1337Transport {
+	public:
+		virtual ~DS1337Transport() {}
+		virtual void begin();
+		virtual byte read(byte address, byte startRegister, byte *data, byte count) = 0;
+		virtual byte write(byte address, byte startRegister, const byte *data, byte count) = 0;
+		virtual byte point(byte address, byte startRegister);
+		virtual byte receive(byte address, byte *data, byte count);
+		virtual byte getReadTransactions();
+		void setClock(unsigned long clock);
+		unsigned long getClock();
+		unsigned long getReadMicros(byte count);
+		unsigned long getWriteMicros(byte count);
+		static unsigned long getBusMicros(int transactions, int bytes, unsigned long clock);
+	protected:
+		DS1337Transport();
+		unsigned long _clock;
+		byte _pointer;
+};
+
+// class definition of the transport over the Arduino Wire library
+class DS1337WireTransport : public DS1337Transport {
+	public:
+		DS1337WireTransport(TwoWire &wire);
+		void begin();
+		byte read(byte address, byte startRegister, byte *data, byte count);
+		byte write(byte address, byte startRegister, const byte *data, byte count);
+		byte point(byte address, byte startRegister);
+		byte receive(byte address, byte *data, byte count);
+	private:
+		TwoWire *_wire;
+};
+
+// class definition of a TCA9548A-style I2C multiplexer (one channel at a time)
+class DS1337Mux {
+	public:
+		DS1337Mux(DS1337Transport &bus, byte address = DS1337_TCA9548A_ID);
+		boolean select(byte channel);
+		void deselect();
+		byte getChannel();
+		DS1337Transport *getBus();
+		unsigned long getSelects();
+	private:
+		DS1337Transport *_bus;
+		byte _address;
+		byte _channel;
+		unsigned long _selects;
+};
+
+// class definition of the transport to one channel of a multiplexer
+class DS1337MuxTransport : public DS1337Transport {
+	public:
+		DS1337MuxTransport(DS1337Mux &mux, byte channel);
+		void begin();
+		byte read(byte address, byte startRegister, byte *data, byte count);
+		byte write(byte address, byte startRegister, const byte *data, byte count);
+		byte point(byte address, byte startRegister);
+		byte receive(byte address, byte *data, byte count);
+		byte getReadTransactions();
+	private:
+		DS1337Mux *_mux;
+		byte _channel;
+};
+
+// default transport over Wire
+extern DS1337WireTransport DS1337Wire;
+
+#endif
@@ -24,58 +24,51 @@ THE SOFTWARE.
 
  */
 #include "DS3231.h"
-#include "Wire.h"
 
 /**
- * Enable alarm
+ * Constructor of class DS3231
  */
-void DS3231::enableAlarm() {
-	readStatus();
-	bitSet(_register[DS1337_CONTROL], DS1337_A1IE);
-	bitSet(_register[DS1337_CONTROL], DS1337_INTCN);
-	writeStatus();
+DS3231::DS3231() : DS1337(DS1337Wire, DS3231Chip::registers, DS3231Chip::features) {
 }
 
 /**
- * Enable alarm
+ * Constructor of class DS3231 with given register transport
  */
-void DS3231::disableAlarm() {
-	readStatus();
-	bitClear(_register[DS1337_CONTROL], DS1337_A1IE);
-	writeStatus();
+DS3231::DS3231(DS1337Transport &transport) : DS1337(transport, DS3231Chip::registers, DS3231Chip::features) {
 }
 
 /**
- * Check, if alarm is enabled
+ * Constructor of class DS3231 with given register transport and I2C address
  */
-boolean DS3231::isAlarmEnabled() {
-	readStatus();
-	return (bitRead(_register[DS1337_CONTROL], DS1337_A1IE) && bitRead(_register[DS1337_CONTROL], DS1337_INTCN));
+DS3231::DS3231(DS1337Transport &transport, byte address) : DS1337(transport, DS3231Chip::registers, DS3231Chip::features) {
+	_address = address;
 }
 
 /**
  * Enable 32KHz signal
  */
 void DS3231::enable32kHz() {
-	readStatus();
+	fetch(DS1337_STATUS, 1);
 	bitSet(_register[DS1337_STATUS], DS3231_EN32KHZ);
-	writeStatus();
+	keepFlags();
+	write(DS1337_STATUS, 1);
 }
 
 /**
  * Disable 32KHz signal
  */
 void DS3231::disable32kHz() {
-	readStatus();
+	fetch(DS1337_STATUS, 1);
 	bitClear(_register[DS1337_STATUS], DS3231_EN32KHZ);
-	writeStatus();
+	keepFlags();
+	write(DS1337_STATUS, 1);
 }
 
 /**
  * Check, if 32KHz signal is enabled
  */
 bool DS3231::is32kHzEnabled() {
-	readStatus();
+	fetch(DS1337_STATUS, 1);
 	return bitRead(_register[DS1337_STATUS], DS3231_EN32KHZ);
 }
 
@@ -83,39 +76,72 @@ bool DS3231::is32kHzEnabled() {
  * Toggle the 32KHz signal
  */
 bool DS3231::toggle32kHz() {
-	if (is32kHzEnabled())
+	if (is32kHzEnabled()) {
 		disable32kHz();
-	else
-		enable32kHz();
+		return false;
+	}
+	enable32kHz();
+	return true;
 }
 
 /**
- * Clear registers
+ * Get the temperature
  */
-void DS3231::clear() {
-	for (int i=0; i<DS3231_REGISTERS; i++) {
-		_register[i] = 0;
-	}
+float DS3231::getTemperature() {
+	return getTemperatureQuarters() / 4.0;
 }
 
 /**
- * Get the temperature
+ * Get the temperature in quarter degrees (fixed point, no float code)
  */
-float DS3231::getTemperature() {
+int DS3231::getTemperatureQuarters() {
 	read(DS3231_TEMP_MSB, DS3231_REGISTERS_TEMP);
-	char c = _register[DS3231_TEMP_MSB];
-	float f = (float)(_register[DS3231_TEMP_LSB] >> 6) / 4.0;
-	float t = (float)c + f;
-	return t;
+	return (int)(int8_t)_register[DS3231_TEMP_MSB] * 4 + (_register[DS3231_TEMP_LSB] >> 6);
 }
 
 /**
- * Start conversion of temperature
+ * Start conversion of temperature, returns false if the DS3231 is busy
  */
-void DS3231::startConversion() {
+boolean DS3231::startConversion() {
 	readStatus();
-	if(!bitRead(_register[DS1337_STATUS], DS3231_BSY)) {
-		bitSet(_register[DS1337_CONTROL], DS3231_CONV);
-		writeStatus();
-	}
+	if (bitRead(_register[DS1337_STATUS], DS3231_BSY))
+		return false;
+	bitSet(_register[DS1337_CONTROL], DS3231_CONV);
+	writeControl();
+	// CONV is cleared by the DS3231 when the conversion is done
+	bitClear(_register[DS1337_CONTROL], DS3231_CONV);
+	return true;
+}
+
+/**
+ * Check, if a started conversion is still running (one byte read, no waiting)
+ */
+boolean DS3231::isConverting() {
+	read(DS1337_CONTROL, 1);
+	boolean converting = bitRead(_register[DS1337_CONTROL], DS3231_CONV);
+	bitClear(_register[DS1337_CONTROL], DS3231_CONV);
+	return converting;
+}
+
+/**
+ * Get the aging offset (-128 .. 127, positive values slow the oscillator)
+ */
+int DS3231::getAgingOffset() {
+	fetch(DS3231_AGING_OFFSET, 1);
+	return (int8_t)_register[DS3231_AGING_OFFSET];
+}
+
+/**
+ * Set the aging offset (about 0.1 ppm per step at +25 degrees, positive values
+ * slow the oscillator). It's applied with the next temperature conversion,
+ * so a conversion is started (if not busy).
+ */
+void DS3231::setAgingOffset(int offset) {
+	if (offset < DS3231_AGING_MIN)
+		offset = DS3231_AGING_MIN;
+	if (offset > DS3231_AGING_MAX)
+		offset = DS3231_AGING_MAX;
+	_register[DS3231_AGING_OFFSET] = (byte)(int8_t)offset;
+	write(DS3231_AGING_OFFSET, 1);
+	startConversion();
 }
@@ -38,6 +38,11 @@ THE SOFTWARE.
 #define DS3231_TEMP_MSB       0x11
 #define DS3231_TEMP_LSB       0x12
 
+// range of the aging offset and its effect at +25 degrees (ppb per step)
+#define DS3231_AGING_MIN		-128
+#define DS3231_AGING_MAX		127
+#define DS3231_AGING_PPB		100
+
 // additional DS3231 status register flags
 #define DS3231_EN32KHZ		0x03
 #define DS3231_BSY			0x02
@@ -45,19 +50,29 @@ THE SOFTWARE.
 // additional DS3231 control register flags
 #define DS3231_CONV			0x05
 
+// chip traits of the DS3231 (compile-time constants)
+struct DS3231Chip {
+	static const byte registers = DS3231_REGISTERS;
+	static const byte features = DS1337_FEATURE_ALARM_INTCN;
+};
+static_assert(DS3231Chip::registers <= DS1337_MAX_REGISTERS, "DS1337_MAX_REGISTERS too small for DS3231");
+
 // class definition of DS3231 RTC
 class DS3231 : public DS1337 {
 public:
-	void enableAlarm();
-	void disableAlarm();
-	boolean isAlarmEnabled();
+	DS3231();
+	DS3231(DS1337Transport &transport);
+	DS3231(DS1337Transport &transport, byte address);
 	void enable32kHz();
 	void disable32kHz();
 	bool is32kHzEnabled();
 	bool toggle32kHz();
-	void clear();
 	float getTemperature();
-	void startConversion();
+	int getTemperatureQuarters();
+	boolean startConversion();
+	boolean isConverting();
+	int getAgingOffset();
+	void setAgingOffset(int offset);
 private:
 };
 
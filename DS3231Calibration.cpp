@@ -0,0 +1,163 @@
+/**
+
+DS3231Calibration.cpp
+
+Copyright by Christian Paul, 2014
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+ */
+#include "DS3231Calibration.h"
+
+/**
+ * Constructor of class DS3231Calibration
+ */
+DS3231Calibration::DS3231Calibration(DS3231 &rtc) {
+	_rtc = &rtc;
+	_window = DS3231_CALIBRATION_WINDOW;
+	_tolerance = DS3231_CALIBRATION_TOLERANCE;
+	_maxWindows = DS3231_CALIBRATION_WINDOWS;
+	_state = DS3231_CALIBRATION_IDLE;
+	_edges = 0;
+	_start = 0;
+	_end = 0;
+	_temperature = 0;
+	_error = 0;
+	_windows = 0;
+}
+
+/**
+ * Set the length of a measurement window (RTC seconds, 1 .. 3600)
+ */
+void DS3231Calibration::setWindow(unsigned long seconds) {
+	_window = constrain(seconds, 1UL, 3600UL);
+}
+
+/**
+ * Set the remaining error to stop at (ppb)
+ */
+void DS3231Calibration::setTolerance(long ppb) {
+	_tolerance = ppb;
+}
+
+/**
+ * Set the max. number of measurement windows
+ */
+void DS3231Calibration::setMaxWindows(byte windows) {
+	_maxWindows = windows;
+}
+
+/**
+ * Start the calibration (the 1 Hz tick of the RTC must be enabled)
+ */
+void DS3231Calibration::begin() {
+	_windows = 0;
+	_error = 0;
+	_state = DS3231_CALIBRATION_START;
+}
+
+/**
+ * Call on every 1 Hz tick of the RTC (e.g. in the interrupt handler)
+ * with the reference time in microseconds at this tick, e.g. micros()
+ * disciplined by a GPS PPS signal
+ */
+void DS3231Calibration::tick(unsigned long reference) {
+	if (_state != DS3231_CALIBRATION_RUNNING)
+		return;
+	if (_edges == 0)
+		_start = reference;
+	_edges++;
+	if (_edges > _window) {
+		_end = reference;
+		_state = DS3231_CALIBRATION_MEASURED;
+	}
+}
+
+/**
+ * Run the calibration from loop: starts a window and evaluates it,
+ * returns true after a window was evaluated.
+ * The frequency error of the window is corrected by the aging offset
+ * (DS3231_AGING_PPB per step). Windows with a temperature change above
+ * DS3231_CALIBRATION_MAX_DRIFT are dropped, because the temperature
+ * compensation of the DS3231 dominates then.
+ */
+boolean DS3231Calibration::update() {
+	if (_state == DS3231_CALIBRATION_START) {
+		_temperature = _rtc->getTemperatureQuarters();
+		_edges = 0;
+		_state = DS3231_CALIBRATION_RUNNING;
+		return false;
+	}
+	if (_state != DS3231_CALIBRATION_MEASURED)
+		return false;
+	_windows++;
+	int temperature = _rtc->getTemperatureQuarters();
+	int drift = temperature - _temperature;
+	_temperature = temperature;
+	// RTC time minus reference time (us), positive if the RTC is fast
+	long deviation = (long)(_window * 1000000UL - (_end - _start));
+	_error = deviation * 1000L / (long)_window;
+	if (drift >= -DS3231_CALIBRATION_MAX_DRIFT && drift <= DS3231_CALIBRATION_MAX_DRIFT) {
+		if (abs(_error) <= _tolerance) {
+			_state = DS3231_CALIBRATION_CONVERGED;
+			return true;
+		}
+		// round to the nearest step, positive offsets slow the oscillator
+		long step = (_error + (_error < 0 ? -DS3231_AGING_PPB / 2 : DS3231_AGING_PPB / 2)) / DS3231_AGING_PPB;
+		step = constrain(step, -DS3231_CALIBRATION_MAX_STEP, DS3231_CALIBRATION_MAX_STEP);
+		_rtc->setAgingOffset(_rtc->getAgingOffset() + step);
+	}
+	_state = _windows >= _maxWindows ? DS3231_CALIBRATION_FAILED : DS3231_CALIBRATION_START;
+	return true;
+}
+
+/**
+ * Get the state (DS3231_CALIBRATION_*)
+ */
+byte DS3231Calibration::getState() {
+	return _state;
+}
+
+/**
+ * Check, if the calibration has converged or failed
+ */
+boolean DS3231Calibration::isFinished() {
+	return _state == DS3231_CALIBRATION_CONVERGED || _state == DS3231_CALIBRATION_FAILED;
+}
+
+/**
+ * Frequency error of the last window (ppb, positive if the RTC is fast)
+ */
+long DS3231Calibration::getError() {
+	return _error;
+}
+
+/**
+ * Temperature at the end of the last window (quarter degrees)
+ */
+int DS3231Calibration::getTemperature() {
+	return _temperature;
+}
+
+/**
+ * Number of evaluated windows
+ */
+byte DS3231Calibration::getWindows() {
+	return _windows;
+}
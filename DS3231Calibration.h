@@ -0,0 +1,81 @@
+/**
+
+DS3231Calibration.h
+
+Copyright by Christian Paul, 2014
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+ */
+#ifndef DS3231Calibration_h
+#define DS3231Calibration_h
+
+// includes
+#include <Arduino.h>
+#include "DS3231.h"
+
+// default length of a measurement window (RTC seconds, max. 3600)
+#define DS3231_CALIBRATION_WINDOW		600UL
+// default remaining error to stop at (ppb)
+#define DS3231_CALIBRATION_TOLERANCE	100L
+// default max. number of measurement windows
+#define DS3231_CALIBRATION_WINDOWS		8
+// max. change of the aging offset per window
+#define DS3231_CALIBRATION_MAX_STEP		32
+// max. temperature change within a window (quarter degrees)
+#define DS3231_CALIBRATION_MAX_DRIFT	4
+
+// states of the calibration
+#define DS3231_CALIBRATION_IDLE			0
+#define DS3231_CALIBRATION_START		1
+#define DS3231_CALIBRATION_RUNNING		2
+#define DS3231_CALIBRATION_MEASURED		3
+#define DS3231_CALIBRATION_CONVERGED	4
+#define DS3231_CALIBRATION_FAILED		5
+
+// class definition of the aging offset calibration against a reference clock
+class DS3231Calibration {
+	public:
+		DS3231Calibration(DS3231 &rtc);
+		void setWindow(unsigned long seconds);
+		void setTolerance(long ppb);
+		void setMaxWindows(byte windows);
+		void begin();
+		void tick(unsigned long reference);
+		boolean update();
+		byte getState();
+		boolean isFinished();
+		long getError();
+		int getTemperature();
+		byte getWindows();
+	private:
+		DS3231 *_rtc;
+		unsigned long _window;
+		long _tolerance;
+		byte _maxWindows;
+		volatile byte _state;
+		volatile unsigned long _edges;
+		volatile unsigned long _start;
+		volatile unsigned long _end;
+		int _temperature;
+		long _error;
+		byte _windows;
+};
+
+#endif
@@ -0,0 +1,163 @@
+/**
+
+DS3231Thermometer.cpp
+
+Copyright by Christian Paul, 2014
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+ */
+#include "DS3231Thermometer.h"
+
+/**
+ * Constructor of class DS3231Thermometer
+ */
+DS3231Thermometer::DS3231Thermometer(DS3231 &rtc) {
+	_rtc = &rtc;
+	_interval = DS3231_THERMOMETER_INTERVAL;
+	_state = DS3231_THERMOMETER_IDLE;
+	_started = false;
+	_last = 0;
+	clear();
+}
+
+/**
+ * Set the seconds between two conversions
+ */
+void DS3231Thermometer::setInterval(unsigned long interval) {
+	_interval = interval;
+}
+
+/**
+ * Run the pipeline (call from loop with the current time, e.g. of DS1337Clock).
+ * Every call only does short bus reads and never waits: start a conversion
+ * when the interval has passed, or check if it's done and read the result.
+ * Returns true, if a new sample was added.
+ */
+boolean DS3231Thermometer::poll(unsigned long timestamp) {
+	if (_state == DS3231_THERMOMETER_IDLE) {
+		if (_started && timestamp - _last < _interval)
+			return false;
+		// retried on the next call, if the DS3231 is busy
+		if (_rtc->startConversion()) {
+			_state = DS3231_THERMOMETER_CONVERTING;
+			_started = true;
+			_last = timestamp;
+		}
+		return false;
+	}
+	if (_rtc->isConverting())
+		return false;
+	push(timestamp, _rtc->getTemperatureQuarters());
+	_state = DS3231_THERMOMETER_IDLE;
+	return true;
+}
+
+/**
+ * Add a sample, the oldest one is dropped if the buffer is full
+ */
+void DS3231Thermometer::push(unsigned long timestamp, int temperature) {
+	byte i = (_first + _count) % DS3231_THERMOMETER_SIZE;
+	boolean full = _count == DS3231_THERMOMETER_SIZE;
+	int dropped = _samples[i].temperature;
+	if (full) {
+		_sum -= dropped;
+		_first = (_first + 1) % DS3231_THERMOMETER_SIZE;
+	}
+	else
+		_count++;
+	_samples[i].timestamp = timestamp;
+	_samples[i].temperature = temperature;
+	_sum += temperature;
+	if (full && (dropped == _minimum || dropped == _maximum)) {
+		// the dropped sample was an extreme: scan again
+		_minimum = _maximum = temperature;
+		for (byte j=0; j<_count; j++) {
+			int t = _samples[j].temperature;
+			if (t < _minimum)
+				_minimum = t;
+			if (t > _maximum)
+				_maximum = t;
+		}
+	}
+	else if (_count == 1) {
+		_minimum = _maximum = temperature;
+	}
+	else {
+		if (temperature < _minimum)
+			_minimum = temperature;
+		if (temperature > _maximum)
+			_maximum = temperature;
+	}
+}
+
+/**
+ * Number of samples in the buffer
+ */
+byte DS3231Thermometer::count() {
+	return _count;
+}
+
+/**
+ * Get a sample (0 is the oldest)
+ */
+boolean DS3231Thermometer::get(byte index, DS3231Temperature &sample) {
+	if (index >= _count)
+		return false;
+	sample = _samples[(_first + index) % DS3231_THERMOMETER_SIZE];
+	return true;
+}
+
+/**
+ * Get the newest sample
+ */
+boolean DS3231Thermometer::getLast(DS3231Temperature &sample) {
+	return _count > 0 && get(_count - 1, sample);
+}
+
+/**
+ * Min./max./mean temperature of the samples in the buffer (quarter degrees)
+ */
+int DS3231Thermometer::getMinimum() {
+	return _minimum;
+}
+
+int DS3231Thermometer::getMaximum() {
+	return _maximum;
+}
+
+int DS3231Thermometer::getMean() {
+	if (_count == 0)
+		return 0;
+	// rounded to the nearest quarter degree
+	if (_sum < 0)
+		return (_sum - _count / 2) / _count;
+	return (_sum + _count / 2) / _count;
+}
+
+/**
+ * Drop all samples
+ */
+void DS3231Thermometer::clear() {
+	_first = 0;
+	_count = 0;
+	_sum = 0;
+	_minimum = 0;
+	_maximum = 0;
+}
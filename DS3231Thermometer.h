@@ -0,0 +1,77 @@
+/**
+
+DS3231Thermometer.h
+
+Copyright by Christian Paul, 2014
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+ */
+#ifndef DS3231Thermometer_h
+#define DS3231Thermometer_h
+
+// includes
+#include <Arduino.h>
+#include "DS3231.h"
+
+// number of samples in the ring buffer
+#define DS3231_THERMOMETER_SIZE		16
+
+// default seconds between two conversions
+#define DS3231_THERMOMETER_INTERVAL	64
+
+// states of the conversion pipeline
+#define DS3231_THERMOMETER_IDLE			0
+#define DS3231_THERMOMETER_CONVERTING	1
+
+// temperature sample (quarter degrees)
+struct DS3231Temperature {
+	unsigned long timestamp;
+	int16_t temperature;
+};
+
+// class definition of a non-blocking temperature sampler with a ring buffer
+class DS3231Thermometer {
+	public:
+		DS3231Thermometer(DS3231 &rtc);
+		void setInterval(unsigned long interval);
+		boolean poll(unsigned long timestamp);
+		byte count();
+		boolean get(byte index, DS3231Temperature &sample);
+		boolean getLast(DS3231Temperature &sample);
+		int getMinimum();
+		int getMaximum();
+		int getMean();
+		void clear();
+	private:
+		void push(unsigned long timestamp, int temperature);
+		DS3231 *_rtc;
+		DS3231Temperature _samples[DS3231_THERMOMETER_SIZE];
+		byte _first;
+		byte _count;
+		byte _state;
+		boolean _started;
+		unsigned long _interval;
+		unsigned long _last;
+		long _sum;
+		int _minimum;
+		int _maximum;
+};
+
+#endif
@@ -24,8 +24,8 @@ DS1337 rtc;
 
 // Date object
 Date dt;
-// tick
-volatile boolean tick = false;
+// ticks (no tick is lost, if the loop is slow)
+DS1337EventQueue events;
 
 void setup() {
   // serial
@@ -59,14 +59,10 @@ void setup() {
 }
 
 void loop() {
-  // check if tick occurs
+  // handle queued ticks and reset the tick flag once
   // don't use rtc over i2c in interrupt routine 
   // only outside
-  if (tick) {
-    Serial.println("Tick Tack");
-    // reset tick
-    rtc.resetTick();
-    tick = false;
+  if (rtc.processEvents(events, onEvent) > 0) {
     // print current date and time
     printDateTime();
     Serial.println();
@@ -75,9 +71,13 @@ void loop() {
 
 // Tick interrupt routine
 void onTick() {
-  noInterrupts();
-  tick = true;
-  interrupts();
+  events.push(DS1337_EVENT_TICK);
+}
+
+// called for every queued tick
+void onEvent(DS1337Event &event) {
+  Serial.print("Tick Tack at ");
+  Serial.println(event.micros);
 }
 
 // print current time and date
@@ -0,0 +1,172 @@
+/**
+
+Arduino.cpp
+
+Copyright by Christian Paul, 2014
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+ */
+#include "Arduino.h"
+#include <stdio.h>
+
+// simulated time in microseconds since hostReset()
+static unsigned long long _micros = 0;
+static int _interruptsDisabled = 0;
+
+unsigned long millis() {
+	return (unsigned long)(_micros / 1000ULL);
+}
+
+unsigned long micros() {
+	return (unsigned long)_micros;
+}
+
+void delay(unsigned long ms) {
+	_micros += (unsigned long long)ms * 1000ULL;
+}
+
+void delayMicroseconds(unsigned int us) {
+	_micros += us;
+}
+
+void noInterrupts() {
+	_interruptsDisabled++;
+}
+
+void interrupts() {
+	if (_interruptsDisabled > 0)
+		_interruptsDisabled--;
+}
+
+void hostAdvanceMicros(unsigned long us) {
+	_micros += us;
+}
+
+unsigned long long hostMicros() {
+	return _micros;
+}
+
+void hostReset() {
+	_micros = 0;
+	_interruptsDisabled = 0;
+	String::resetStatistics();
+}
+
+/**
+ * Print
+ */
+size_t Print::write(const uint8_t *buffer, size_t size) {
+	size_t n = 0;
+	while (size--) {
+		if (write(*buffer++))
+			n++;
+		else
+			break;
+	}
+	return n;
+}
+
+size_t Print::write(const char *str) {
+	return write((const uint8_t *)str, strlen(str));
+}
+
+size_t Print::print(const char *str) {
+	return write(str);
+}
+
+size_t Print::print(char c) {
+	return write((uint8_t)c);
+}
+
+size_t Print::print(long n) {
+	char buffer[24];
+	snprintf(buffer, sizeof(buffer), "%ld", n);
+	return write(buffer);
+}
+
+size_t Print::print(unsigned long n) {
+	char buffer[24];
+	snprintf(buffer, sizeof(buffer), "%lu", n);
+	return write(buffer);
+}
+
+size_t Print::print(int n) {
+	return print((long)n);
+}
+
+size_t Print::println(const char *str) {
+	return print(str) + println();
+}
+
+size_t Print::println() {
+	return write("\r\n");
+}
+
+/**
+ * String
+ */
+unsigned long String::allocations = 0;
+unsigned long String::allocatedBytes = 0;
+
+String::String(const char *str) {
+	copy(str, strlen(str));
+}
+
+String::String(const String &str) {
+	copy(str._buffer, str._length);
+}
+
+String::~String() {
+	free(_buffer);
+}
+
+String &String::operator=(const String &str) {
+	if (this != &str) {
+		free(_buffer);
+		copy(str._buffer, str._length);
+	}
+	return *this;
+}
+
+bool String::operator==(const char *str) const {
+	return strcmp(_buffer, str) == 0;
+}
+
+const char *String::c_str() const {
+	return _buffer;
+}
+
+unsigned int String::length() const {
+	return _length;
+}
+
+void String::resetStatistics() {
+	allocations = 0;
+	allocatedBytes = 0;
+}
+
+void String::copy(const char *str, unsigned int length) {
+	_length = length;
+	_buffer = (char *)malloc(length + 1);
+	allocations++;
+	allocatedBytes += length + 1;
+	memcpy(_buffer, str, length);
+	_buffer[length] = 0;
+}
@@ -0,0 +1,114 @@
+/**
+
+Arduino.h
+
+Copyright by Christian Paul, 2014
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+ */
+
+/**
+ * Minimal stand-in of the Arduino core to build and test the library on a host (Linux).
+ * Time is simulated: millis()/micros() only advance with delay(), delayMicroseconds(),
+ * hostAdvanceMicros() and with the bus time of simulated I2C transactions (see Wire.h).
+ */
+#ifndef ARDUINO_H
+#define ARDUINO_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+
+typedef uint8_t byte;
+typedef bool boolean;
+
+#define HIGH 0x1
+#define LOW  0x0
+
+#define bitRead(value, bit) (((value) >> (bit)) & 0x01)
+#define bitSet(value, bit) ((value) |= (1UL << (bit)))
+#define bitClear(value, bit) ((value) &= ~(1UL << (bit)))
+#define bitWrite(value, bit, bitvalue) ((bitvalue) ? bitSet(value, bit) : bitClear(value, bit))
+#define _BV(bit) (1 << (bit))
+#define constrain(amt, low, high) ((amt) < (low) ? (low) : ((amt) > (high) ? (high) : (amt)))
+
+// binary constants used by the library (binary.h)
+#define B1101000 104
+
+// time
+unsigned long millis();
+unsigned long micros();
+void delay(unsigned long ms);
+void delayMicroseconds(unsigned int us);
+
+// interrupts are not simulated, the calls only count the nesting
+void noInterrupts();
+void interrupts();
+
+// host simulation: advance and reset the simulated time
+void hostAdvanceMicros(unsigned long us);
+unsigned long long hostMicros();
+void hostReset();
+
+/**
+ * Print base class, derived classes implement write(uint8_t)
+ */
+class Print {
+	public:
+		virtual ~Print() {}
+		virtual size_t write(uint8_t c) = 0;
+		virtual size_t write(const uint8_t *buffer, size_t size);
+		size_t write(const char *str);
+		size_t print(const char *str);
+		size_t print(char c);
+		size_t print(long n);
+		size_t print(unsigned long n);
+		size_t print(int n);
+		size_t println(const char *str);
+		size_t println();
+};
+
+/**
+ * String with heap buffer, counts allocations to compare formatters on the host
+ */
+class String {
+	public:
+		String(const char *str = "");
+		String(const String &str);
+		~String();
+		String &operator=(const String &str);
+		bool operator==(const char *str) const;
+		const char *c_str() const;
+		unsigned int length() const;
+
+		// host statistics
+		static unsigned long allocations;
+		static unsigned long allocatedBytes;
+		static void resetStatistics();
+
+	private:
+		void copy(const char *str, unsigned int length);
+		char *_buffer;
+		unsigned int _length;
+};
+
+#endif
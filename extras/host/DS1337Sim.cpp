@@ -0,0 +1,438 @@
+/**
+
+DS1337Sim.cpp
+
+Copyright by Christian Paul, 2014
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+ */
+#include "DS1337Sim.h"
+
+/**
+ * Simulated DS1337 (16 registers) or DS3231 (19 registers)
+ */
+DS1337Sim::DS1337Sim(bool ds3231) {
+	_ds3231 = ds3231;
+	_count = ds3231 ? DS3231SIM_REGISTERS : DS1337SIM_REGISTERS;
+	_drift = 0;
+	_temperature = 25 * 4;
+	powerOn();
+}
+
+/**
+ * Power on without backup: registers at their power-on state, 2000-01-01 00:00:00,
+ * oscillator running and OSF set
+ */
+void DS1337Sim::powerOn() {
+	memset(_register, 0, sizeof(_register));
+	_register[DS1337SIM_DAY_OF_WEEK] = 6;
+	_register[0x04] = 0x01;
+	_register[DS1337SIM_MONTH] = 0x01;
+	if (_ds3231) {
+		_register[DS1337SIM_CONTROL] = 0x1C;
+		_register[DS1337SIM_STATUS] = DS1337SIM_OSF | DS3231SIM_EN32KHZ;
+		_register[DS3231SIM_TEMP_MSB] = (uint8_t)(int8_t)(_temperature >> 2);
+		_register[DS3231SIM_TEMP_LSB] = (uint8_t)((_temperature & 3) << 6);
+	} else {
+		_register[DS1337SIM_CONTROL] = 0x18;
+		_register[DS1337SIM_STATUS] = DS1337SIM_OSF;
+	}
+	_pointer = 0;
+	_halted = false;
+	_micros = hostMicros();
+	_phase = 0;
+	_driftRemainder = 0;
+	_agingApplied = 0;
+	_busy = false;
+	_conversionEnd = 0;
+	_ticks = 0;
+	_conversions = 0;
+}
+
+/**
+ * Master write: register pointer followed by data (auto increment, wraps to 0)
+ */
+bool DS1337Sim::receive(const uint8_t *data, size_t count) {
+	sync();
+	if (count == 0)
+		return true;
+	_pointer = data[0] % _count;
+	for (size_t i=1; i<count; i++) {
+		writeRegister(_pointer, data[i]);
+		_pointer = (_pointer + 1) % _count;
+	}
+	return true;
+}
+
+/**
+ * Master read from the register pointer on (auto increment, wraps to 0)
+ */
+size_t DS1337Sim::transmit(uint8_t *data, size_t count) {
+	sync();
+	for (size_t i=0; i<count; i++) {
+		data[i] = _register[_pointer];
+		_pointer = (_pointer + 1) % _count;
+	}
+	return count;
+}
+
+/**
+ * Write one register with the semantics of the chip
+ */
+void DS1337Sim::writeRegister(uint8_t reg, uint8_t value) {
+	switch (reg) {
+		case DS1337SIM_SECONDS:
+			// writing the seconds resets the countdown chain
+			_register[reg] = value & 0x7F;
+			_phase = 0;
+			_driftRemainder = 0;
+			break;
+		case DS1337SIM_CONTROL:
+			if (_ds3231) {
+				bool start = (value & DS3231SIM_CONV) && !_busy;
+				// CONV is cleared by the chip when the conversion is done
+				value = (value & ~DS3231SIM_CONV) | (_register[reg] & DS3231SIM_CONV);
+				_register[reg] = value;
+				if (start) {
+					_register[reg] |= DS3231SIM_CONV;
+					startConversion();
+				}
+			} else {
+				_register[reg] = value & 0x9F;
+				// EOSC stops the oscillator of the DS1337 (the DS3231 only on battery)
+				if (value & DS1337SIM_EOSC)
+					_register[DS1337SIM_STATUS] |= DS1337SIM_OSF;
+			}
+			break;
+		case DS1337SIM_STATUS: {
+			// OSF, A2F and A1F: writing 0 clears, writing 1 leaves unchanged; BSY is read only
+			uint8_t status = _register[reg] & (value | ~(DS1337SIM_OSF | DS1337SIM_A2F | DS1337SIM_A1F));
+			if (_ds3231)
+				status = (status & ~DS3231SIM_EN32KHZ) | (value & DS3231SIM_EN32KHZ);
+			_register[reg] = status;
+			break;
+		}
+		case DS3231SIM_TEMP_MSB:
+		case DS3231SIM_TEMP_LSB:
+			break;
+		default:
+			_register[reg] = value;
+	}
+}
+
+/**
+ * Catch up with the simulated time: second ticks and end of conversions in order
+ */
+void DS1337Sim::sync() {
+	unsigned long long now = hostMicros();
+	while (_micros < now) {
+		unsigned long long step = now - _micros;
+		if (_busy && _conversionEnd - _micros < step)
+			step = _conversionEnd - _micros;
+		if (isRunning()) {
+			unsigned long long next = nextSecond();
+			if (next < step)
+				step = next;
+		}
+		advance(step);
+	}
+}
+
+/**
+ * Advance the oscillator by some microseconds of simulated (true) time
+ */
+void DS1337Sim::advance(unsigned long long micros) {
+	_micros += micros;
+	if (isRunning()) {
+		_driftRemainder += (long long)micros * (_drift - (long long)_agingApplied * DS3231SIM_AGING_PPB);
+		long long drift = _driftRemainder / 1000000LL;
+		_driftRemainder -= drift * 1000000LL;
+		_phase += micros * 1000ULL + drift;
+		if (_phase >= 1000000000ULL) {
+			_phase -= 1000000000ULL;
+			tick();
+		}
+	}
+	if (_busy && _micros >= _conversionEnd)
+		finishConversion();
+}
+
+/**
+ * Simulated microseconds until the next seconds edge
+ */
+unsigned long DS1337Sim::microsToNextSecond() {
+	sync();
+	return nextSecond();
+}
+
+unsigned long DS1337Sim::nextSecond() {
+	long long ppb = _drift - (long long)_agingApplied * DS3231SIM_AGING_PPB;
+	unsigned long long remaining = 1000000000ULL - _phase;
+	unsigned long long micros = remaining * 1000000ULL / (unsigned long long)(1000000000LL + ppb);
+	// exact with the rounding of advance(): the first microsecond reaching the edge
+	while (micros * 1000ULL + (_driftRemainder + (long long)micros * ppb) / 1000000LL < remaining)
+		micros++;
+	while (micros > 1 && (micros - 1) * 1000ULL + (_driftRemainder + (long long)(micros - 1) * ppb) / 1000000LL >= remaining)
+		micros--;
+	return micros > 0 ? (unsigned long)micros : 1;
+}
+
+bool DS1337Sim::isRunning() {
+	return !_halted && !(!_ds3231 && (_register[DS1337SIM_CONTROL] & DS1337SIM_EOSC));
+}
+
+/**
+ * One second: count up the calendar (24 hour mode, leap years for 2000-2099)
+ */
+void DS1337Sim::tick() {
+	_ticks++;
+	uint8_t *r = _register;
+	int seconds = fromBcd(r[0] & 0x7F) + 1;
+	r[0] = toBcd(seconds % 60);
+	if (seconds >= 60) {
+		int minutes = fromBcd(r[1] & 0x7F) + 1;
+		r[1] = toBcd(minutes % 60);
+		if (minutes >= 60) {
+			int hour = fromBcd(r[2] & 0x3F) + 1;
+			r[2] = toBcd(hour % 24);
+			if (hour >= 24) {
+				r[3] = (r[3] & 0x07) % 7 + 1;
+				int year = fromBcd(r[6]);
+				int month = fromBcd(r[5] & 0x1F);
+				int day = fromBcd(r[4] & 0x3F) + 1;
+				int days = (month == 2) ? ((year % 4 == 0) ? 29 : 28) : 30 + ((month + (month >> 3)) & 1);
+				if (day > days) {
+					day = 1;
+					if (++month > 12) {
+						month = 1;
+						if (++year > 99) {
+							year = 0;
+							r[5] ^= 0x80;
+						}
+						r[6] = toBcd(year);
+					}
+					r[5] = (r[5] & 0x80) | toBcd(month);
+				}
+				r[4] = toBcd(day);
+			}
+		}
+	}
+	matchAlarms();
+	if (_ds3231 && _ticks % DS3231SIM_CONVERSION_PERIOD == 0 && !_busy)
+		startConversion();
+}
+
+/**
+ * Set A1F/A2F on a match of the unmasked alarm fields (alarm 2 has no seconds)
+ */
+void DS1337Sim::matchAlarms() {
+	const uint8_t *r = _register;
+	const uint8_t *a1 = r + DS1337SIM_A1_SECONDS;
+	bool match = true;
+	for (int i=0; i<3; i++) {
+		if (!(a1[i] & 0x80) && (a1[i] & 0x7F) != (r[i] & 0x7F))
+			match = false;
+	}
+	if (!(a1[3] & 0x80)) {
+		if (a1[3] & 0x40)
+			match = match && (a1[3] & 0x07) == (r[3] & 0x07);
+		else
+			match = match && (a1[3] & 0x3F) == (r[4] & 0x3F);
+	}
+	if (match)
+		_register[DS1337SIM_STATUS] |= DS1337SIM_A1F;
+
+	const uint8_t *a2 = r + DS1337SIM_A2_MINUTES;
+	match = (r[0] == 0);
+	for (int i=0; i<2; i++) {
+		if (!(a2[i] & 0x80) && (a2[i] & 0x7F) != (r[i + 1] & 0x7F))
+			match = false;
+	}
+	if (!(a2[2] & 0x80)) {
+		if (a2[2] & 0x40)
+			match = match && (a2[2] & 0x07) == (r[3] & 0x07);
+		else
+			match = match && (a2[2] & 0x3F) == (r[4] & 0x3F);
+	}
+	if (match)
+		_register[DS1337SIM_STATUS] |= DS1337SIM_A2F;
+}
+
+/**
+ * Temperature conversion (forced by CONV or every 64 seconds), BSY while it runs
+ */
+void DS1337Sim::startConversion() {
+	_busy = true;
+	_conversionEnd = _micros + DS3231SIM_CONVERSION_MICROS;
+	_register[DS1337SIM_STATUS] |= DS3231SIM_BSY;
+}
+
+/**
+ * End of the conversion: temperature registers updated, aging offset applied
+ */
+void DS1337Sim::finishConversion() {
+	_busy = false;
+	_conversions++;
+	_register[DS1337SIM_STATUS] &= ~DS3231SIM_BSY;
+	_register[DS1337SIM_CONTROL] &= ~DS3231SIM_CONV;
+	_register[DS3231SIM_TEMP_MSB] = (uint8_t)(int8_t)(_temperature >> 2);
+	_register[DS3231SIM_TEMP_LSB] = (uint8_t)((_temperature & 3) << 6);
+	_agingApplied = (int8_t)_register[DS3231SIM_AGING];
+}
+
+/**
+ * Set the time registers (year 2000..2199, day of week 1 = Monday .. 7 = Sunday)
+ */
+void DS1337Sim::setDateTime(int year, int month, int day, int hour, int minutes, int seconds) {
+	sync();
+	int y = year - (month <= 2);
+	long era = y / 400;
+	long yoe = y - era * 400;
+	long doy = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1;
+	long days = era * 146097 + yoe * 365 + yoe / 4 - yoe / 100 + doy - 719468;
+	_register[0] = toBcd(seconds);
+	_register[1] = toBcd(minutes);
+	_register[2] = toBcd(hour);
+	_register[3] = (uint8_t)((days + 3) % 7 + 1);
+	_register[4] = toBcd(day);
+	_register[5] = toBcd(month) | (year >= 2100 ? 0x80 : 0);
+	_register[6] = toBcd(year % 100);
+	_phase = 0;
+	_driftRemainder = 0;
+}
+
+/**
+ * Set the time registers from a unix timestamp
+ */
+void DS1337Sim::setTimestamp(unsigned long timestamp) {
+	long days = (long)(timestamp / 86400UL) + 719468;
+	long era = days / 146097;
+	long doe = days - era * 146097;
+	long yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+	long doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+	long mp = (5 * doy + 2) / 153;
+	int day = (int)(doy - (153 * mp + 2) / 5 + 1);
+	int month = (int)(mp < 10 ? mp + 3 : mp - 9);
+	int year = (int)(yoe + era * 400 + (month <= 2));
+	unsigned long seconds = timestamp % 86400UL;
+	setDateTime(year, month, day, seconds / 3600, (seconds / 60) % 60, seconds % 60);
+}
+
+/**
+ * Unix timestamp of the time registers
+ */
+unsigned long DS1337Sim::getTimestamp() {
+	sync();
+	int year = 2000 + fromBcd(_register[6]) + ((_register[5] & 0x80) ? 100 : 0);
+	int month = fromBcd(_register[5] & 0x1F);
+	int day = fromBcd(_register[4] & 0x3F);
+	int y = year - (month <= 2);
+	long era = y / 400;
+	long yoe = y - era * 400;
+	long doy = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1;
+	long days = era * 146097 + yoe * 365 + yoe / 4 - yoe / 100 + doy - 719468;
+	return (unsigned long)days * 86400UL + fromBcd(_register[2] & 0x3F) * 3600UL + fromBcd(_register[1] & 0x7F) * 60UL + fromBcd(_register[0] & 0x7F);
+}
+
+/**
+ * Raw register access without side effects
+ */
+uint8_t DS1337Sim::peek(uint8_t reg) {
+	sync();
+	return _register[reg % _count];
+}
+
+void DS1337Sim::poke(uint8_t reg, uint8_t value) {
+	sync();
+	_register[reg % _count] = value;
+}
+
+/**
+ * Frequency error of the oscillator in ppb (positive runs fast)
+ */
+void DS1337Sim::setDrift(long ppb) {
+	sync();
+	_drift = ppb;
+}
+
+long DS1337Sim::getDrift() {
+	return _drift;
+}
+
+/**
+ * Temperature for the next conversion (quarter degrees)
+ */
+void DS1337Sim::setTemperatureQuarters(int quarters) {
+	_temperature = quarters;
+}
+
+/**
+ * Stop/restart the oscillator (e.g. power fail without backup), stopping sets OSF
+ */
+void DS1337Sim::haltOscillator(bool halted) {
+	sync();
+	_halted = halted;
+	if (halted)
+		_register[DS1337SIM_STATUS] |= DS1337SIM_OSF;
+}
+
+/**
+ * State of an interrupt pin (true: asserted). INTCN=1: DS1337 A1 on INTA, A2 on INTB,
+ * DS3231 both on INT; INTCN=0: DS1337 both alarms on INTA, DS3231 square wave only.
+ */
+bool DS1337Sim::isInterrupt(uint8_t pin) {
+	sync();
+	uint8_t control = _register[DS1337SIM_CONTROL];
+	uint8_t status = _register[DS1337SIM_STATUS];
+	bool a1 = (control & DS1337SIM_A1IE) && (status & DS1337SIM_A1F);
+	bool a2 = (control & DS1337SIM_A2IE) && (status & DS1337SIM_A2F);
+	bool intcn = control & DS1337SIM_INTCN;
+	if (_ds3231)
+		return pin == DS1337SIM_INTA && intcn && (a1 || a2);
+	if (pin == DS1337SIM_INTA)
+		return a1 || (!intcn && a2);
+	return intcn && a2;
+}
+
+unsigned long DS1337Sim::getTicks() {
+	sync();
+	return _ticks;
+}
+
+unsigned long DS1337Sim::getConversions() {
+	sync();
+	return _conversions;
+}
+
+uint8_t DS1337Sim::getPointer() {
+	return _pointer;
+}
+
+uint8_t DS1337Sim::getRegisterCount() {
+	return _count;
+}
+
+uint8_t DS1337Sim::toBcd(int value) {
+	return (uint8_t)((value / 10) << 4 | (value % 10));
+}
+
+int DS1337Sim::fromBcd(uint8_t value) {
+	return (value >> 4) * 10 + (value & 0x0F);
+}
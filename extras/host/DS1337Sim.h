@@ -0,0 +1,138 @@
+/**
+
+DS1337Sim.h
+
+Copyright by Christian Paul, 2014
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+ */
+
+/**
+ * Simulated DS1337/DS3231 for the host build. Models the registers 0x00-0x12 with the
+ * register pointer, a running (optionally drifting) oscillator with calendar, the alarm
+ * match logic setting A1F/A2F, OSF at power on and oscillator stop, write-0-to-clear flags,
+ * and on the DS3231 the temperature conversions (BSY/CONV), EN32KHZ and the aging offset.
+ * The simulation follows the simulated time of Arduino.h, bus costs are charged by Wire.h.
+ */
+#ifndef DS1337Sim_h
+#define DS1337Sim_h
+
+#include "Arduino.h"
+#include "Wire.h"
+
+// registers
+#define DS1337SIM_REGISTERS     16
+#define DS3231SIM_REGISTERS     19
+#define DS1337SIM_SECONDS     0x00
+#define DS1337SIM_DAY_OF_WEEK 0x03
+#define DS1337SIM_MONTH       0x05
+#define DS1337SIM_YEAR        0x06
+#define DS1337SIM_A1_SECONDS  0x07
+#define DS1337SIM_A2_MINUTES  0x0B
+#define DS1337SIM_CONTROL     0x0E
+#define DS1337SIM_STATUS      0x0F
+#define DS3231SIM_AGING       0x10
+#define DS3231SIM_TEMP_MSB    0x11
+#define DS3231SIM_TEMP_LSB    0x12
+
+// control bits
+#define DS1337SIM_A1IE   0x01
+#define DS1337SIM_A2IE   0x02
+#define DS1337SIM_INTCN  0x04
+#define DS3231SIM_CONV   0x20
+#define DS1337SIM_EOSC   0x80
+
+// status bits
+#define DS1337SIM_A1F      0x01
+#define DS1337SIM_A2F      0x02
+#define DS3231SIM_BSY      0x04
+#define DS3231SIM_EN32KHZ  0x08
+#define DS1337SIM_OSF      0x80
+
+// interrupt pins (INTA resp. INT/SQW, SQW/INTB)
+#define DS1337SIM_INTA  0
+#define DS1337SIM_INTB  1
+
+// temperature conversion time (us), period of the automatic conversions (s)
+#define DS3231SIM_CONVERSION_MICROS  200000UL
+#define DS3231SIM_CONVERSION_PERIOD  64
+
+// frequency change per aging offset LSB (ppb)
+#define DS3231SIM_AGING_PPB  100
+
+class DS1337Sim : public WireDevice {
+	public:
+		DS1337Sim(bool ds3231 = false);
+
+		// I2C slave
+		bool receive(const uint8_t *data, size_t count);
+		size_t transmit(uint8_t *data, size_t count);
+
+		// simulation control
+		void powerOn();
+		void setDateTime(int year, int month, int day, int hour, int minutes, int seconds);
+		void setTimestamp(unsigned long timestamp);
+		unsigned long getTimestamp();
+		uint8_t peek(uint8_t reg);
+		void poke(uint8_t reg, uint8_t value);
+		void setDrift(long ppb);
+		long getDrift();
+		void setTemperatureQuarters(int quarters);
+		void haltOscillator(bool halted);
+		bool isInterrupt(uint8_t pin);
+		unsigned long microsToNextSecond();
+		unsigned long getTicks();
+		unsigned long getConversions();
+		uint8_t getPointer();
+		uint8_t getRegisterCount();
+
+	private:
+		void sync();
+		void advance(unsigned long long micros);
+		unsigned long nextSecond();
+		void tick();
+		void matchAlarms();
+		void startConversion();
+		void finishConversion();
+		void writeRegister(uint8_t reg, uint8_t value);
+		bool isRunning();
+		static uint8_t toBcd(int value);
+		static int fromBcd(uint8_t value);
+
+		bool _ds3231;
+		uint8_t _count;
+		uint8_t _register[DS3231SIM_REGISTERS];
+		uint8_t _pointer;
+		bool _halted;
+
+		unsigned long long _micros;
+		unsigned long long _phase;
+		long long _driftRemainder;
+		long _drift;
+		int _agingApplied;
+		int _temperature;
+
+		bool _busy;
+		unsigned long long _conversionEnd;
+		unsigned long _ticks;
+		unsigned long _conversions;
+};
+
+#endif
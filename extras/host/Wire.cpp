@@ -0,0 +1,246 @@
+/**
+
+Wire.cpp
+
+Copyright by Christian Paul, 2014
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+ */
+#include "Wire.h"
+
+TwoWire Wire;
+
+/**
+ * Simulated multiplexer, all channels disconnected after power on
+ */
+WireMux::WireMux() {
+	_control = 0;
+}
+
+bool WireMux::receive(const uint8_t *data, size_t count) {
+	if (count > 0)
+		_control = data[count - 1];
+	return true;
+}
+
+size_t WireMux::transmit(uint8_t *data, size_t count) {
+	for (size_t i=0; i<count; i++)
+		data[i] = _control;
+	return count;
+}
+
+bool WireMux::isConnected(uint8_t channel) {
+	return channel < 8 && bitRead(_control, channel);
+}
+
+/**
+ * Bus with no devices at standard mode
+ */
+TwoWire::TwoWire() {
+	_deviceCount = 0;
+	_clock = 100000UL;
+	_address = 0;
+	_txLength = 0;
+	_rxLength = 0;
+	_rxIndex = 0;
+	resetStatistics();
+}
+
+void TwoWire::begin() {
+}
+
+void TwoWire::setClock(uint32_t clock) {
+	_clock = clock;
+}
+
+void TwoWire::beginTransmission(uint8_t address) {
+	_address = address;
+	_txLength = 0;
+}
+
+void TwoWire::beginTransmission(int address) {
+	beginTransmission((uint8_t)address);
+}
+
+size_t TwoWire::write(uint8_t data) {
+	if (_txLength >= WIRE_BUFFER_LENGTH)
+		return 0;
+	_txBuffer[_txLength++] = data;
+	return 1;
+}
+
+size_t TwoWire::write(const uint8_t *data, size_t count) {
+	size_t n = 0;
+	while (n < count && write(data[n]))
+		n++;
+	return n;
+}
+
+/**
+ * Send the buffered bytes (0: success, 2: address not acknowledged, 3: data not acknowledged)
+ */
+uint8_t TwoWire::endTransmission(bool sendStop) {
+	WireDevice *device = find(_address);
+	if (device == NULL) {
+		charge(1, sendStop);
+		return 2;
+	}
+	charge(1 + _txLength, sendStop);
+	if (!device->receive(_txBuffer, _txLength))
+		return 3;
+	return 0;
+}
+
+/**
+ * Read bytes from a device into the receive buffer (returns the number of bytes read)
+ */
+uint8_t TwoWire::requestFrom(uint8_t address, uint8_t count, uint8_t sendStop) {
+	_rxIndex = 0;
+	_rxLength = 0;
+	if (count > WIRE_BUFFER_LENGTH)
+		count = WIRE_BUFFER_LENGTH;
+	WireDevice *device = find(address);
+	if (device == NULL) {
+		charge(1, sendStop);
+		return 0;
+	}
+	charge(1 + count, sendStop);
+	_rxLength = (uint8_t)device->transmit(_rxBuffer, count);
+	return _rxLength;
+}
+
+uint8_t TwoWire::requestFrom(uint8_t address, uint8_t count) {
+	return requestFrom(address, count, (uint8_t)true);
+}
+
+uint8_t TwoWire::requestFrom(int address, int count) {
+	return requestFrom((uint8_t)address, (uint8_t)count, (uint8_t)true);
+}
+
+uint8_t TwoWire::requestFrom(int address, int count, int sendStop) {
+	return requestFrom((uint8_t)address, (uint8_t)count, (uint8_t)sendStop);
+}
+
+int TwoWire::available() {
+	return _rxLength - _rxIndex;
+}
+
+int TwoWire::read() {
+	if (_rxIndex >= _rxLength)
+		return -1;
+	return _rxBuffer[_rxIndex++];
+}
+
+int TwoWire::peek() {
+	if (_rxIndex >= _rxLength)
+		return -1;
+	return _rxBuffer[_rxIndex];
+}
+
+/**
+ * Attach a device to the bus
+ */
+void TwoWire::attach(uint8_t address, WireDevice &device) {
+	if (_deviceCount >= WIRE_DEVICES)
+		return;
+	Slot &slot = _devices[_deviceCount++];
+	slot.address = address;
+	slot.device = &device;
+	slot.mux = NULL;
+	slot.channel = 0;
+}
+
+/**
+ * Attach a device to a channel of a multiplexer
+ */
+void TwoWire::attach(uint8_t address, WireDevice &device, WireMux &mux, uint8_t channel) {
+	attach(address, device);
+	if (_devices[_deviceCount - 1].device == &device) {
+		_devices[_deviceCount - 1].mux = &mux;
+		_devices[_deviceCount - 1].channel = channel;
+	}
+}
+
+/**
+ * Remove a device from the bus
+ */
+void TwoWire::detach(WireDevice &device) {
+	uint8_t n = 0;
+	for (uint8_t i=0; i<_deviceCount; i++) {
+		if (_devices[i].device != &device)
+			_devices[n++] = _devices[i];
+	}
+	_deviceCount = n;
+}
+
+/**
+ * Find the device answering an address, devices behind a multiplexer only answer on a
+ * connected channel (more than one answering device counts as collision)
+ */
+WireDevice *TwoWire::find(uint8_t address) {
+	WireDevice *found = NULL;
+	for (uint8_t i=0; i<_deviceCount; i++) {
+		Slot &slot = _devices[i];
+		if (slot.address != address)
+			continue;
+		if (slot.mux != NULL && !slot.mux->isConnected(slot.channel))
+			continue;
+		if (found != NULL) {
+			_collisions++;
+			continue;
+		}
+		found = slot.device;
+	}
+	return found;
+}
+
+/**
+ * Count one transaction of some bytes (address byte included) and advance the
+ * simulated time by its duration at the bus clock
+ */
+void TwoWire::charge(unsigned long bytes, bool sendStop) {
+	unsigned long bits = WIRE_START_BITS + (sendStop ? WIRE_STOP_BITS : 0) + bytes * WIRE_BYTE_BITS;
+	unsigned long long total = (unsigned long long)bits * 1000000ULL + _remainder;
+	unsigned long us = (unsigned long)(total / _clock);
+	_remainder = total % _clock;
+	_transactions++;
+	_bytes += bytes;
+	_busNanos += (unsigned long long)bits * 1000000000ULL / _clock;
+	unsigned long transactionMicros = (unsigned long)(((unsigned long long)bits * 1000000ULL + _clock - 1) / _clock);
+	if (transactionMicros > _maxTransactionMicros)
+		_maxTransactionMicros = transactionMicros;
+	hostAdvanceMicros(us);
+}
+
+uint32_t TwoWire::getClock() { return _clock; }
+unsigned long TwoWire::getTransactions() { return _transactions; }
+unsigned long TwoWire::getBytes() { return _bytes; }
+unsigned long TwoWire::getBusMicros() { return (unsigned long)(_busNanos / 1000ULL); }
+unsigned long TwoWire::getMaxTransactionMicros() { return _maxTransactionMicros; }
+unsigned long TwoWire::getCollisions() { return _collisions; }
+
+void TwoWire::resetStatistics() {
+	_transactions = 0;
+	_bytes = 0;
+	_busNanos = 0;
+	_maxTransactionMicros = 0;
+	_collisions = 0;
+	_remainder = 0;
+}
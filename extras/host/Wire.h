@@ -0,0 +1,129 @@
+/**
+
+Wire.h
+
+Copyright by Christian Paul, 2014
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+ */
+
+/**
+ * Stand-in of the Arduino Wire library for the host build. Transactions are routed to
+ * simulated devices attached to the bus (directly or behind a simulated multiplexer),
+ * counted and charged to the simulated time at the bus clock (see Arduino.h).
+ */
+#ifndef TwoWire_h
+#define TwoWire_h
+
+#include "Arduino.h"
+
+#define WIRE_BUFFER_LENGTH 32
+#define WIRE_DEVICES       16
+
+// bus timing (in bit times)
+#define WIRE_START_BITS  1
+#define WIRE_STOP_BITS   1
+#define WIRE_BYTE_BITS   9
+
+// interface of a simulated I2C slave
+class WireDevice {
+	public:
+		virtual ~WireDevice() {}
+		// master write (the device acknowledges with true)
+		virtual bool receive(const uint8_t *data, size_t count) = 0;
+		// master read (returns the number of bytes sent)
+		virtual size_t transmit(uint8_t *data, size_t count) = 0;
+};
+
+// simulated TCA9548A multiplexer: one control register, bit n connects channel n
+class WireMux : public WireDevice {
+	public:
+		WireMux();
+		bool receive(const uint8_t *data, size_t count);
+		size_t transmit(uint8_t *data, size_t count);
+		bool isConnected(uint8_t channel);
+	private:
+		uint8_t _control;
+};
+
+class TwoWire {
+	public:
+		TwoWire();
+		void begin();
+		void setClock(uint32_t clock);
+		void beginTransmission(uint8_t address);
+		void beginTransmission(int address);
+		size_t write(uint8_t data);
+		size_t write(const uint8_t *data, size_t count);
+		uint8_t endTransmission(bool sendStop = true);
+		uint8_t requestFrom(uint8_t address, uint8_t count);
+		uint8_t requestFrom(uint8_t address, uint8_t count, uint8_t sendStop);
+		uint8_t requestFrom(int address, int count);
+		uint8_t requestFrom(int address, int count, int sendStop);
+		int available();
+		int read();
+		int peek();
+
+		// host simulation: devices on the bus
+		void attach(uint8_t address, WireDevice &device);
+		void attach(uint8_t address, WireDevice &device, WireMux &mux, uint8_t channel);
+		void detach(WireDevice &device);
+
+		// host statistics
+		uint32_t getClock();
+		unsigned long getTransactions();
+		unsigned long getBytes();
+		unsigned long getBusMicros();
+		unsigned long getMaxTransactionMicros();
+		unsigned long getCollisions();
+		void resetStatistics();
+
+	private:
+		WireDevice *find(uint8_t address);
+		void charge(unsigned long bytes, bool sendStop);
+
+		struct Slot {
+			uint8_t address;
+			WireDevice *device;
+			WireMux *mux;
+			uint8_t channel;
+		};
+		Slot _devices[WIRE_DEVICES];
+		uint8_t _deviceCount;
+
+		uint32_t _clock;
+		uint8_t _address;
+		uint8_t _txBuffer[WIRE_BUFFER_LENGTH];
+		uint8_t _txLength;
+		uint8_t _rxBuffer[WIRE_BUFFER_LENGTH];
+		uint8_t _rxLength;
+		uint8_t _rxIndex;
+
+		unsigned long _transactions;
+		unsigned long _bytes;
+		unsigned long long _busNanos;
+		unsigned long _maxTransactionMicros;
+		unsigned long _collisions;
+		unsigned long long _remainder;
+};
+
+extern TwoWire Wire;
+
+#endif
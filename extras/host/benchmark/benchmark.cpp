@@ -0,0 +1,273 @@
+/**
+
+benchmark.cpp
+
+Copyright by Christian Paul, 2014
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+ */
+#include <stdio.h>
+#include <chrono>
+#include "DS1337Sim.h"
+#include "DS1337.h"
+#include "DS3231.h"
+
+// calls per benchmark
+#define BENCH_CALLS 100
+
+// buffers
+#define BENCH_BATCH 32
+static char text[DS1337_ISO8601_SIZE];
+static unsigned long timestamps[BENCH_BATCH];
+static byte years[BENCH_BATCH], months[BENCH_BATCH], days[BENCH_BATCH];
+static byte hours[BENCH_BATCH], minutes[BENCH_BATCH], seconds[BENCH_BATCH];
+
+// simulated DS3231 on Wire
+static DS1337Sim sim(true);
+static DS3231 rtc;
+static DS1337EventQueue events;
+
+// keeps the compiler from dropping results
+static volatile unsigned long sink;
+
+// result of one run at one bus clock
+struct BenchRun {
+	unsigned long long cpuNanos;
+	unsigned long transactions;
+	unsigned long bytes;
+	unsigned long busMicros;
+	unsigned long maxMicros;
+	unsigned long heapBytes;
+};
+
+/**
+ * Run a benchmark at a bus clock: host time, bus traffic, longest call in
+ * simulated time and bytes allocated by String
+ */
+static void run(void (*fn)(), unsigned long calls, unsigned long clock, BenchRun &result) {
+	Wire.setClock(clock);
+	rtc.getTransport()->setClock(clock);
+	Wire.resetStatistics();
+	String::resetStatistics();
+	result.maxMicros = 0;
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	for (unsigned long i=0; i<calls; i++) {
+		unsigned long long begin = hostMicros();
+		fn();
+		unsigned long elapsed = (unsigned long)(hostMicros() - begin);
+		if (elapsed > result.maxMicros)
+			result.maxMicros = elapsed;
+	}
+	result.cpuNanos = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+	result.transactions = Wire.getTransactions();
+	result.bytes = Wire.getBytes();
+	result.busMicros = Wire.getBusMicros();
+	result.heapBytes = String::allocatedBytes;
+}
+
+/**
+ * Run a benchmark at 100 kHz and 400 kHz and print its CSV line (per call)
+ */
+static void bench(const char *name, void (*fn)(), unsigned long calls = BENCH_CALLS) {
+	BenchRun standard, fast;
+	run(fn, calls, DS1337_I2C_STANDARD_MODE, standard);
+	run(fn, calls, DS1337_I2C_FAST_MODE, fast);
+	printf("%s%s,%lu,%llu,%lu,%lu,%lu,%lu,%lu,%lu,%lu\n",
+		name, rtc.isCacheEnabled() ? "_cached" : "", calls,
+		standard.cpuNanos / calls,
+		standard.transactions / calls,
+		standard.bytes / calls,
+		standard.busMicros / calls,
+		fast.busMicros / calls,
+		standard.maxMicros,
+		fast.maxMicros,
+		standard.heapBytes / calls);
+}
+
+// boot configuration, without and within a transaction
+static void boot() {
+	rtc.setDateTime(24, 3, 7, 9, 5, 30);
+	rtc.setAlarm(7, 9, 30, 0);
+	rtc.setAlarmMode(DS1337_ALARM_ON_SECOND_MINUTE_HOUR_DATE);
+	rtc.setTickMode(DS1337_NO_TICKS);
+	rtc.clearFlags();
+}
+
+static void onEvent(DS1337Event &event) {
+	sink = event.kind;
+}
+
+/**
+ * Conversion, formatting and parsing (no bus)
+ */
+static void benchConversions() {
+	bench("getTime", []() {
+		int y, mo, d, h, mi, s;
+		DS1337::getTime(sink + 1709802330UL, y, mo, d, h, mi, s);
+		sink = y + mo + d + h + mi + s;
+	});
+	bench("getTimestamp", []() {
+		sink = DS1337::getTimestamp(24, 3, 7, 9, 5, sink & 31);
+	});
+	bench("getTime_batch32", []() {
+		DS1337::getTime(timestamps, years, months, days, hours, minutes, seconds, BENCH_BATCH);
+		sink = years[BENCH_BATCH - 1];
+	}, BENCH_CALLS / 10);
+	bench("getTimestamp_batch32", []() {
+		DS1337::getTimestamp(years, months, days, hours, minutes, seconds, timestamps, BENCH_BATCH);
+		sink = timestamps[BENCH_BATCH - 1];
+	}, BENCH_CALLS / 10);
+	bench("decodeDate", []() {
+		static const byte registers[DS1337_REGISTERS_DATE] = {0x30, 0x05, 0x09, 0x04, 0x07, 0x03, 0x24};
+		Date d;
+		DS1337::decodeDate(registers, d);
+		sink = d.getSeconds();
+	});
+	bench("formatISO8601", []() {
+		Date d(24, 3, 7, 9, 5, 30);
+		d.formatISO8601(text);
+		sink = text[18];
+	});
+	bench("format_pattern", []() {
+		Date d(24, 3, 7, 9, 5, 30);
+		sink = d.format(text, sizeof(text), "DD.MM.YYYY hh:mm:ss");
+	});
+	bench("getTimeString", []() {
+		Date d(24, 3, 7, 9, 5, 30);
+		sink = d.getTimeString().length();
+	});
+	bench("formatTime", []() {
+		Date d(24, 3, 7, 9, 5, 30);
+		sink = d.formatTime(text)[7];
+	});
+	bench("getDateString", []() {
+		Date d(24, 3, 7, 9, 5, 30);
+		sink = d.getDateString().length();
+	});
+	bench("formatDate", []() {
+		Date d(24, 3, 7, 9, 5, 30);
+		sink = d.formatDate(text)[7];
+	});
+	bench("parseDateTime", []() {
+		int y, mo, d, h, mi, s;
+		sink = DS1337::parseDateTime("2024-03-07 09:05:30", 19, y, mo, d, h, mi, s) + s;
+	});
+	bench("Date_addMinutes", []() {
+		Date d(24, 3, 7, 23, 55, 0);
+		d.addMinutes(10);
+		sink = d.getDay();
+	});
+}
+
+/**
+ * Bus cost of the public methods
+ */
+static void benchMethods() {
+	bench("getDate", []() { sink = rtc.getDate().getSeconds(); });
+	bench("setDate", []() { rtc.setDate(24, 3, 7); });
+	bench("setTime", []() { rtc.setTime(9, 5, 30); });
+	bench("setDayOfWeek", []() { rtc.setDayOfWeek(4); });
+	bench("setDateTime_timestamp", []() { rtc.setDateTime(1709802330UL); });
+	bench("getTimestamp_rtc", []() { sink = rtc.getTimestamp(); });
+	bench("getInstant", []() { Date d; int dow; sink = rtc.getInstant(d, dow); });
+	bench("getAlignedInstant", []() { Date d; int dow; sink = rtc.getAlignedInstant(d, dow); }, BENCH_CALLS / 10);
+	bench("getDayOfWeek", []() { sink = rtc.getDayOfWeek(); });
+	bench("getRegister", []() { sink = rtc.getRegister(DS1337_REGISTERS_DATE); });
+	bench("snapshot", []() { sink = rtc.snapshot().getStatus(); });
+	bench("requestDate_poll", []() { rtc.requestDate(); while (!rtc.poll()); sink = rtc.getRequestedDate().getSeconds(); });
+	bench("poll", []() {
+		// starts a new read only when the last one is ready
+		rtc.requestDate();
+		if (rtc.poll())
+			sink = rtc.getRequestedDate().getSeconds();
+	});
+	bench("stop", []() { rtc.stop(); });
+	bench("start", []() { rtc.start(); });
+	bench("isRunning", []() { sink = rtc.isRunning(); });
+	bench("hasStopped", []() { sink = rtc.hasStopped(); });
+	bench("clearOSF", []() { rtc.clearOSF(); });
+	bench("clearFlags", []() { rtc.clearFlags(); });
+	bench("setAlarm", []() { rtc.setAlarm(7, 9, 30, 0); });
+	bench("getAlarm", []() { sink = rtc.getAlarm().getMinutes(); });
+	bench("saveAlarm", []() { rtc.saveAlarm(); });
+	bench("restoreAlarm", []() { rtc.restoreAlarm(); });
+	bench("setAlarmMode", []() { rtc.setAlarmMode(DS1337_ALARM_ON_SECOND_MINUTE_HOUR_DATE); });
+	bench("getAlarmMode", []() { sink = rtc.getAlarmMode(); });
+	bench("enableAlarm", []() { rtc.enableAlarm(); });
+	bench("isAlarmEnabled", []() { sink = rtc.isAlarmEnabled(); });
+	bench("isAlarmActive", []() { sink = rtc.isAlarmActive(); });
+	bench("clearAlarm", []() { rtc.clearAlarm(); });
+	bench("toggleAlarm", []() { rtc.toggleAlarm(); });
+	bench("snooze", []() { rtc.snooze(5); });
+	bench("disableAlarm", []() { rtc.disableAlarm(); });
+	bench("processEvents", []() {
+		events.push(DS1337_EVENT_ALARM);
+		sink = rtc.processEvents(events, onEvent);
+	});
+	bench("setTickMode", []() { rtc.setTickMode(DS1337_NO_TICKS); });
+	bench("getTickMode", []() { sink = rtc.getTickMode(); });
+	bench("isTickActive", []() { sink = rtc.isTickActive(); });
+	bench("resetTick", []() { rtc.resetTick(); });
+	bench("setAlarm2", []() { sink = rtc.setAlarm2(7, 9, 30); });
+	bench("getAlarm2", []() { sink = rtc.getAlarm2().getMinutes(); });
+	bench("setAlarm2Mode", []() { sink = rtc.setAlarm2Mode(DS1337_ALARM2_ON_MINUTE_HOUR_DATE); });
+	bench("getAlarm2Mode", []() { sink = rtc.getAlarm2Mode(); });
+	bench("enableAlarm2", []() { sink = rtc.enableAlarm2(); });
+	bench("isAlarm2Enabled", []() { sink = rtc.isAlarm2Enabled(); });
+	bench("isAlarm2Active", []() { sink = rtc.isAlarm2Active(); });
+	bench("clearAlarm2", []() { rtc.clearAlarm2(); });
+	bench("disableAlarm2", []() { rtc.disableAlarm2(); });
+	bench("boot", []() { boot(); });
+	bench("transaction_boot", []() {
+		rtc.beginTransaction();
+		boot();
+		rtc.commit();
+	});
+	bench("getTemperature", []() { sink = (unsigned long)rtc.getTemperature(); });
+	bench("getTemperatureQuarters", []() { sink = rtc.getTemperatureQuarters(); });
+	bench("startConversion", []() { sink = rtc.startConversion(); });
+	bench("isConverting", []() { sink = rtc.isConverting(); });
+	bench("enable32kHz", []() { rtc.enable32kHz(); });
+	bench("is32kHzEnabled", []() { sink = rtc.is32kHzEnabled(); });
+	bench("toggle32kHz", []() { sink = rtc.toggle32kHz(); });
+	bench("disable32kHz", []() { rtc.disable32kHz(); });
+	bench("getAgingOffset", []() { sink = rtc.getAgingOffset(); });
+	bench("setAgingOffset", []() { rtc.setAgingOffset(0); });
+}
+
+int main() {
+	hostReset();
+	Wire.attach(DS1337_ID, sim);
+	rtc.init();
+	rtc.clearOSF();
+	rtc.setDateTime(24, 3, 7, 9, 5, 30);
+	for (int i=0; i<BENCH_BATCH; i++)
+		timestamps[i] = 1709802330UL + i * 86413UL;
+
+	printf("# DS1337 benchmark (simulated DS3231)\n");
+	printf("name,calls,cpu_ns,transactions,bytes,bus_us_100k,bus_us_400k,max_us_100k,max_us_400k,heap_bytes\n");
+	benchConversions();
+	benchMethods();
+	rtc.enableCache();
+	benchMethods();
+	rtc.disableCache();
+	printf("# done\n");
+	return 0;
+}
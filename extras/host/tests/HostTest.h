@@ -0,0 +1,62 @@
+/**
+
+HostTest.h
+
+Copyright by Christian Paul, 2014
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+ */
+
+/**
+ * Minimal checks for the host tests: a failed check prints its location and
+ * makes testResult() return a non-zero exit code
+ */
+#ifndef HostTest_h
+#define HostTest_h
+
+#include <stdio.h>
+
+static int testFailures = 0;
+static int testChecks = 0;
+
+#define CHECK(condition) do { \
+	testChecks++; \
+	if (!(condition)) { \
+		printf("%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #condition); \
+		testFailures++; \
+	} \
+} while (0)
+
+#define CHECK_EQUAL(expected, actual) do { \
+	long long expected_ = (long long)(expected); \
+	long long actual_ = (long long)(actual); \
+	testChecks++; \
+	if (expected_ != actual_) { \
+		printf("%s:%d: CHECK_EQUAL(%s, %s) failed: %lld != %lld\n", __FILE__, __LINE__, #expected, #actual, expected_, actual_); \
+		testFailures++; \
+	} \
+} while (0)
+
+static int testResult() {
+	printf("%d checks, %d failures\n", testChecks, testFailures);
+	return testFailures != 0;
+}
+
+#endif
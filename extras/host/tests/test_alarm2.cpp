@@ -0,0 +1,131 @@
+/**
+
+test_alarm2.cpp
+
+Copyright by Christian Paul, 2014
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+ */
+#include "HostTest.h"
+#include "DS1337Sim.h"
+#include "DS1337.h"
+#include "DS3231.h"
+
+// alarm 2 armed in hardware survives a reset of the MCU (new object, init)
+static void testAlarm2AfterReset(DS1337 &rtc, DS1337 &restarted, DS1337Sim &sim) {
+	rtc.init();
+	CHECK(rtc.setTickMode(DS1337_NO_TICKS));
+	CHECK(rtc.setAlarm2(15, 7, 30));
+	CHECK(rtc.setAlarm2Mode(DS1337_ALARM2_ON_MINUTE_HOUR));
+	CHECK(rtc.enableAlarm2());
+	CHECK(rtc.isAlarm2Enabled());
+	byte minutes = sim.peek(0x0B), hour = sim.peek(0x0C), day = sim.peek(0x0D);
+
+	restarted.init();
+	CHECK(restarted.isAlarm2Enabled());
+	CHECK(restarted.isAlarm2Available());
+	CHECK_EQUAL(DS1337_NO_TICKS, restarted.getTickMode());
+	CHECK(!restarted.setTickMode(DS1337_TICK_EVERY_MINUTE));
+	CHECK(!restarted.setTickMode(DS1337_TICK_EVERY_HOUR));
+	CHECK_EQUAL(minutes, sim.peek(0x0B));
+	CHECK_EQUAL(hour, sim.peek(0x0C));
+	CHECK_EQUAL(day, sim.peek(0x0D));
+	CHECK_EQUAL(DS1337_ALARM2_ON_MINUTE_HOUR, restarted.getAlarm2Mode());
+
+	// the alarm fires at 07:30
+	sim.setDateTime(2024, 1, 15, 7, 29, 59);
+	restarted.clearAlarm2();
+	hostAdvanceMicros(1000000UL);
+	CHECK(restarted.isAlarm2Active());
+
+	// disabled, alarm 2 is free for the ticks again
+	restarted.disableAlarm2();
+	CHECK(!restarted.isAlarm2Enabled());
+	CHECK(restarted.setTickMode(DS1337_TICK_EVERY_MINUTE));
+}
+
+// a minute or hour tick in hardware blocks alarm 2 after a reset of the MCU
+static void testTickAfterReset(DS1337 &rtc, DS1337 &restarted) {
+	rtc.init();
+	CHECK(rtc.setTickMode(DS1337_TICK_EVERY_HOUR));
+	restarted.init();
+	CHECK_EQUAL(DS1337_TICK_EVERY_HOUR, restarted.getTickMode());
+	CHECK(!restarted.isAlarm2Enabled());
+	CHECK(!restarted.isAlarm2Available());
+	CHECK(!restarted.setAlarm2(10, 0));
+	CHECK(!restarted.enableAlarm2());
+
+	restarted.init();
+	CHECK(restarted.setTickMode(DS1337_TICK_EVERY_MINUTE));
+	rtc.init();
+	CHECK_EQUAL(DS1337_TICK_EVERY_MINUTE, rtc.getTickMode());
+	CHECK(!rtc.setAlarm2Mode(DS1337_ALARM2_ON_MINUTE));
+	CHECK(rtc.setTickMode(DS1337_NO_TICKS));
+	CHECK(rtc.isAlarm2Available());
+}
+
+// an alarm 2 of the user with the register pattern of a tick (every minute, or
+// on minute 00) stays an alarm and can be changed and disabled
+static void testTickShapedAlarm2(DS1337 &rtc, DS1337 &restarted) {
+	rtc.init();
+	CHECK(rtc.setTickMode(DS1337_NO_TICKS));
+	CHECK(rtc.setAlarm2(0, 0));
+	CHECK(rtc.setAlarm2Mode(DS1337_ALARM2_ON_MINUTE));
+	CHECK(rtc.enableAlarm2());
+	restarted.init();
+	CHECK(restarted.isAlarm2Enabled());
+	CHECK_EQUAL(DS1337_NO_TICKS, restarted.getTickMode());
+	CHECK(restarted.setAlarm2Mode(DS1337_ALARM2_EVERY_MINUTE));
+	CHECK(restarted.isAlarm2Enabled());
+	CHECK_EQUAL(DS1337_NO_TICKS, restarted.getTickMode());
+	CHECK(restarted.setAlarm2(12, 0));
+	CHECK_EQUAL(DS1337_ALARM2_EVERY_MINUTE, restarted.getAlarm2Mode());
+	restarted.disableAlarm2();
+	CHECK(!restarted.isAlarm2Enabled());
+
+	// the registers of a disabled tick are taken over by the alarm
+	CHECK(rtc.setTickMode(DS1337_TICK_EVERY_MINUTE));
+	CHECK(rtc.setTickMode(DS1337_NO_TICKS));
+	CHECK(rtc.enableAlarm2());
+	restarted.init();
+	CHECK(restarted.isAlarm2Enabled());
+	CHECK_EQUAL(DS1337_NO_TICKS, restarted.getTickMode());
+	restarted.disableAlarm2();
+}
+
+int main() {
+	hostReset();
+	DS1337Sim sim1337(false);
+	Wire.attach(DS1337_ID, sim1337);
+	DS1337 rtc1337, restarted1337;
+	testAlarm2AfterReset(rtc1337, restarted1337, sim1337);
+	testTickAfterReset(rtc1337, restarted1337);
+	testTickShapedAlarm2(rtc1337, restarted1337);
+	Wire.detach(sim1337);
+
+	DS1337Sim sim3231(true);
+	Wire.attach(DS1337_ID, sim3231);
+	DS3231 rtc3231, restarted3231;
+	testAlarm2AfterReset(rtc3231, restarted3231, sim3231);
+	testTickAfterReset(rtc3231, restarted3231);
+	testTickShapedAlarm2(rtc3231, restarted3231);
+	Wire.detach(sim3231);
+	return testResult();
+}
@@ -0,0 +1,99 @@
+/**
+
+test_async.cpp
+
+Copyright by Christian Paul, 2014
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+ */
+#include "HostTest.h"
+#include "DS1337Sim.h"
+#include "DS1337.h"
+
+// poll until the requested date is ready, returns the longest single poll (us)
+static unsigned long pollDate(DS1337 &rtc, int &polls, unsigned long gap) {
+	unsigned long worst = 0;
+	polls = 0;
+	CHECK(rtc.requestDate());
+	while (polls < 100) {
+		unsigned long start = micros();
+		boolean ready = rtc.poll();
+		unsigned long elapsed = micros() - start;
+		if (elapsed > worst)
+			worst = elapsed;
+		polls++;
+		if (ready)
+			break;
+		// the main loop does other things between two polls
+		hostAdvanceMicros(gap);
+	}
+	return worst;
+}
+
+// every poll is one short transaction, the blocking getDate is one long read
+static void testBlocking(DS1337 &rtc, DS1337Sim &sim, unsigned long clock) {
+	Wire.setClock(clock);
+	rtc.getTransport()->setClock(clock);
+	sim.setDateTime(2022, 3, 4, 5, 6, 7);
+	hostAdvanceMicros(100000UL);
+	int polls;
+	unsigned long worst = pollDate(rtc, polls, 1000);
+	CHECK(rtc.isDateReady());
+	Date d = rtc.getRequestedDate();
+	CHECK_EQUAL(22, d.getYear());
+	CHECK_EQUAL(3, d.getMonth());
+	CHECK_EQUAL(7, d.getSeconds());
+	CHECK(worst <= DS1337Transport::getBusMicros(1, 1 + DS1337_ASYNC_CHUNK, clock));
+
+	unsigned long start = micros();
+	rtc.getDate();
+	unsigned long blocking = micros() - start;
+	CHECK_EQUAL(rtc.getTransport()->getReadMicros(DS1337_REGISTERS_DATE), blocking);
+	CHECK(worst < blocking / 2);
+}
+
+// the seconds roll over between two polls: the read restarts and stays consistent
+static void testRollover(DS1337 &rtc, DS1337Sim &sim) {
+	sim.setDateTime(2022, 12, 31, 23, 59, 59);
+	hostAdvanceMicros(1000000UL - 1500UL);
+	int polls;
+	pollDate(rtc, polls, 1000);
+	CHECK(rtc.isDateReady());
+	Date d = rtc.getRequestedDate();
+	CHECK_EQUAL(23, d.getYear());
+	CHECK_EQUAL(1, d.getMonth());
+	CHECK_EQUAL(1, d.getDay());
+	CHECK_EQUAL(0, d.getHour());
+	CHECK_EQUAL(0, d.getMinutes());
+	CHECK_EQUAL(0, d.getSeconds());
+	CHECK(polls > 6);
+}
+
+int main() {
+	hostReset();
+	DS1337Sim sim(false);
+	Wire.attach(DS1337_ID, sim);
+	DS1337 rtc;
+	rtc.init();
+	testBlocking(rtc, sim, DS1337_I2C_STANDARD_MODE);
+	testBlocking(rtc, sim, DS1337_I2C_FAST_MODE);
+	testRollover(rtc, sim);
+	return testResult();
+}
@@ -0,0 +1,78 @@
+/**
+
+test_batch.cpp
+
+Copyright by Christian Paul, 2014
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+ */
+#include "HostTest.h"
+#include "DS1337.h"
+
+#define COUNT 1003
+
+static unsigned long timestamps[COUNT];
+static unsigned long converted[COUNT];
+static byte year[COUNT], month[COUNT], day[COUNT], hour[COUNT], minute[COUNT], second[COUNT];
+
+// the batch conversions give the same fields and timestamps as the scalar ones
+// (a count not a multiple of the vector width, so the loop tail is run too)
+static void testBatch() {
+	unsigned long seed = 1;
+	timestamps[0] = 946684800UL;
+	timestamps[1] = 951782400UL;	// 2000-02-29
+	timestamps[2] = 4102444799UL;	// 2099-12-31 23:59:59
+	timestamps[3] = 0xFFFFFFFFUL;	// 2106-02-07 06:28:15
+	for (int i=4; i<COUNT; i++) {
+		seed = (seed * 1103515245UL + 12345UL) & 0xFFFFFFFFUL;
+		timestamps[i] = 946684800UL + seed % (0xFFFFFFFFUL - 946684800UL);
+	}
+	DS1337::getTime(timestamps, year, month, day, hour, minute, second, COUNT);
+	for (int i=0; i<COUNT; i++) {
+		int y, mo, d, h, mi, s;
+		DS1337::getTime(timestamps[i], y, mo, d, h, mi, s);
+		CHECK(year[i] == y && month[i] == mo && day[i] == d);
+		CHECK(hour[i] == h && minute[i] == mi && second[i] == s);
+	}
+	DS1337::getTimestamp(year, month, day, hour, minute, second, converted, COUNT);
+	for (int i=0; i<COUNT; i++) {
+		CHECK_EQUAL(DS1337::getTimestamp(year[i], month[i], day[i], hour[i], minute[i], second[i]), converted[i]);
+		CHECK_EQUAL(timestamps[i], converted[i]);
+	}
+	CHECK_EQUAL(99, year[2]);
+	CHECK_EQUAL(106, year[3]);
+	CHECK_EQUAL(29, day[1]);
+}
+
+// an empty batch writes nothing
+static void testEmpty() {
+	year[0] = 42;
+	converted[0] = 42;
+	DS1337::getTime(timestamps, year, month, day, hour, minute, second, 0);
+	DS1337::getTimestamp(year, month, day, hour, minute, second, converted, 0);
+	CHECK_EQUAL(42, year[0]);
+	CHECK_EQUAL(42UL, converted[0]);
+}
+
+int main() {
+	testBatch();
+	testEmpty();
+	return testResult();
+}
@@ -0,0 +1,100 @@
+/**
+
+test_cache.cpp
+
+Copyright by Christian Paul, 2014
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+ */
+#include "HostTest.h"
+#include "DS1337Sim.h"
+#include "DS1337.h"
+
+// a read is two transactions (register pointer, then the data), a write one
+
+// with a valid cache the setters only write, the getters don't touch the bus
+static void testSetters(DS1337 &rtc) {
+	rtc.enableCache();
+	rtc.getAlarmMode();
+	rtc.isAlarmEnabled();
+	Wire.resetStatistics();
+	rtc.setAlarmMode(DS1337_ALARM_ON_SECOND_MINUTE);
+	CHECK_EQUAL(1UL, Wire.getTransactions());
+	rtc.enableAlarm();
+	CHECK_EQUAL(2UL, Wire.getTransactions());
+	rtc.disableAlarm();
+	CHECK_EQUAL(3UL, Wire.getTransactions());
+	CHECK_EQUAL(DS1337_ALARM_ON_SECOND_MINUTE, rtc.getAlarmMode());
+	CHECK(!rtc.isAlarmEnabled());
+	CHECK_EQUAL(3UL, Wire.getTransactions());
+
+	// without the cache every setter is a read-modify-write
+	rtc.disableCache();
+	Wire.resetStatistics();
+	rtc.setAlarmMode(DS1337_ALARM_ON_SECOND);
+	rtc.enableAlarm();
+	CHECK_EQUAL(6UL, Wire.getTransactions());
+}
+
+// invalidateCache() fetches registers changed by someone else again
+static void testInvalidate(DS1337 &rtc, DS1337Sim &sim) {
+	rtc.enableCache();
+	rtc.disableAlarm();
+	CHECK(!rtc.isAlarmEnabled());
+	sim.poke(DS1337SIM_CONTROL, sim.peek(DS1337SIM_CONTROL) | DS1337SIM_A1IE);
+	Wire.resetStatistics();
+	CHECK(!rtc.isAlarmEnabled());
+	CHECK_EQUAL(0UL, Wire.getTransactions());
+	rtc.invalidateCache();
+	CHECK(rtc.isAlarmEnabled());
+	CHECK_EQUAL(2UL, Wire.getTransactions());
+	CHECK(rtc.isAlarmEnabled());
+	CHECK_EQUAL(2UL, Wire.getTransactions());
+
+	// a setter after invalidating reads once, then only writes
+	rtc.setAlarmMode(DS1337_ALARM_EVERY_SECOND);
+	CHECK_EQUAL(5UL, Wire.getTransactions());
+	rtc.setAlarmMode(DS1337_ALARM_ON_SECOND);
+	CHECK_EQUAL(6UL, Wire.getTransactions());
+}
+
+// the date and hardware flags are never cached
+static void testUncached(DS1337 &rtc) {
+	rtc.enableCache();
+	rtc.getDate();
+	Wire.resetStatistics();
+	rtc.getDate();
+	CHECK_EQUAL(2UL, Wire.getTransactions());
+	rtc.isAlarmActive();
+	rtc.isAlarmActive();
+	CHECK_EQUAL(6UL, Wire.getTransactions());
+}
+
+int main() {
+	hostReset();
+	DS1337Sim sim(false);
+	Wire.attach(DS1337_ID, sim);
+	DS1337 rtc;
+	rtc.init();
+	testSetters(rtc);
+	testInvalidate(rtc, sim);
+	testUncached(rtc);
+	return testResult();
+}
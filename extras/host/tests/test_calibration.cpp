@@ -0,0 +1,92 @@
+/**
+
+test_calibration.cpp
+
+Copyright by Christian Paul, 2014
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+ */
+#include "HostTest.h"
+#include "DS1337Sim.h"
+#include "DS3231Calibration.h"
+
+// run the calibration: the simulated time (micros) is the reference clock, the
+// RTC ticks at its own (drifting) seconds edges
+static void run(DS3231Calibration &calibration, DS1337Sim &sim, unsigned long seconds, int temperatureStep) {
+	for (unsigned long i=0; i<seconds && !calibration.isFinished(); i++) {
+		hostAdvanceMicros(sim.microsToNextSecond());
+		calibration.tick(micros());
+		calibration.update();
+		if (i == 300 && temperatureStep != 0)
+			sim.setTemperatureQuarters(100 + temperatureStep);
+	}
+}
+
+// 2.5 ppm fast: one window measures it, the aging offset corrects it, the next window converges
+static void testConverge() {
+	DS1337Sim sim(true);
+	Wire.attach(DS1337_ID, sim);
+	DS3231 rtc;
+	rtc.init();
+	sim.setDrift(2500);
+	DS3231Calibration calibration(rtc);
+	calibration.begin();
+	run(calibration, sim, 3000, 0);
+	CHECK_EQUAL(DS3231_CALIBRATION_CONVERGED, calibration.getState());
+	CHECK_EQUAL(2, calibration.getWindows());
+	CHECK_EQUAL(25, rtc.getAgingOffset());
+	CHECK(abs(calibration.getError()) <= DS3231_CALIBRATION_TOLERANCE);
+
+	// the corrected RTC keeps the reference time
+	sim.setTimestamp(1700000000UL);
+	delay(86400UL * 1000UL);
+	CHECK_EQUAL(1700086400UL, sim.getTimestamp());
+	Wire.detach(sim);
+}
+
+// a window with a temperature change is dropped, the offset stays
+static void testTemperatureChange() {
+	DS1337Sim sim(true);
+	Wire.attach(DS1337_ID, sim);
+	sim.setTemperatureQuarters(100);
+	DS3231 rtc;
+	rtc.init();
+	rtc.startConversion();
+	delay(200);
+	sim.setDrift(-1200);
+	DS3231Calibration calibration(rtc);
+	calibration.setWindow(600);
+	calibration.begin();
+	run(calibration, sim, 650, 8);
+	CHECK_EQUAL(1, calibration.getWindows());
+	CHECK_EQUAL(0, rtc.getAgingOffset());
+	CHECK(calibration.getError() < -1000);
+	run(calibration, sim, 3000, 0);
+	CHECK_EQUAL(DS3231_CALIBRATION_CONVERGED, calibration.getState());
+	CHECK_EQUAL(-12, rtc.getAgingOffset());
+	Wire.detach(sim);
+}
+
+int main() {
+	hostReset();
+	testConverge();
+	testTemperatureChange();
+	return testResult();
+}
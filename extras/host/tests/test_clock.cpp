@@ -0,0 +1,99 @@
+/**
+
+test_clock.cpp
+
+Copyright by Christian Paul, 2014
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+ */
+#include "HostTest.h"
+#include "DS1337Sim.h"
+#include "DS1337Clock.h"
+
+// an aligned clock across many resyncs: the phase of the ticks is kept and the
+// timestamps never go back
+static void testResync() {
+	DS1337Sim sim(false);
+	Wire.attach(DS1337_ID, sim);
+	DS1337 rtc;
+	rtc.init();
+	sim.setTimestamp(1700000000UL);
+	hostAdvanceMicros(400000UL);
+	DS1337Clock clock(rtc);
+	clock.setSyncInterval(2950);
+	clock.begin();
+	CHECK(!clock.isAligned());
+
+	unsigned long lastSeconds = 0;
+	unsigned int lastMilliseconds = 0;
+	for (int step=0; step<300; step++) {
+		unsigned long edge = sim.microsToNextSecond();
+		if (edge <= 100000UL) {
+			hostAdvanceMicros(edge);
+			clock.tick();
+			hostAdvanceMicros(100000UL - edge);
+		} else {
+			hostAdvanceMicros(100000UL);
+		}
+		unsigned int milliseconds;
+		unsigned long seconds = clock.getTimestamp(milliseconds);
+		CHECK(seconds > lastSeconds || (seconds == lastSeconds && milliseconds >= lastMilliseconds));
+		lastSeconds = seconds;
+		lastMilliseconds = milliseconds;
+		if (step < 20)
+			continue;
+		// aligned: within a few ms of the RTC
+		CHECK(clock.isAligned());
+		long long rtcMillis = (long long)sim.getTimestamp() * 1000 + 1000 - (sim.microsToNextSecond() + 999) / 1000;
+		long long clockMillis = (long long)seconds * 1000 + milliseconds;
+		CHECK(clockMillis - rtcMillis <= 2 && rtcMillis - clockMillis <= 2);
+	}
+	Wire.detach(sim);
+}
+
+// a sync corrects whole seconds of an aligned clock (e.g. the RTC was set)
+static void testCorrect() {
+	DS1337Sim sim(false);
+	Wire.attach(DS1337_ID, sim);
+	DS1337 rtc;
+	rtc.init();
+	sim.setTimestamp(1700000000UL);
+	DS1337Clock clock(rtc);
+	clock.setSyncInterval(0);
+	clock.begin();
+	hostAdvanceMicros(sim.microsToNextSecond());
+	clock.tick();
+	hostAdvanceMicros(300000UL);
+	CHECK_EQUAL(1700000001UL, clock.getTimestamp());
+	sim.setTimestamp(sim.getTimestamp() + 60);
+	clock.sync();
+	CHECK(clock.isAligned());
+	unsigned int milliseconds;
+	CHECK_EQUAL(1700000061UL, clock.getTimestamp(milliseconds));
+	CHECK(milliseconds >= 300 && milliseconds < 310);
+	Wire.detach(sim);
+}
+
+int main() {
+	hostReset();
+	testResync();
+	testCorrect();
+	return testResult();
+}
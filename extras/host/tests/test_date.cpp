@@ -0,0 +1,95 @@
+/**
+
+test_date.cpp
+
+Copyright by Christian Paul, 2014
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+ */
+#include "HostTest.h"
+#include "DS1337.h"
+#include <time.h>
+
+// days of a month match the calendar of getDays (Gregorian, year 0 is 2000)
+static void testDaysInMonth() {
+	CHECK_EQUAL(29, Date::daysInMonth(0, 2));
+	CHECK_EQUAL(28, Date::daysInMonth(23, 2));
+	CHECK_EQUAL(29, Date::daysInMonth(24, 2));
+	CHECK_EQUAL(28, Date::daysInMonth(100, 2));
+	CHECK_EQUAL(28, Date::daysInMonth(300, 2));
+	CHECK_EQUAL(29, Date::daysInMonth(400, 2));
+	CHECK_EQUAL(31, Date::daysInMonth(100, 1));
+	CHECK_EQUAL(30, Date::daysInMonth(100, 4));
+	for (int year=0; year<=450; year++) {
+		for (int month=1; month<=12; month++) {
+			int next = DS1337::getDays(month == 12 ? year + 1 : year, month == 12 ? 1 : month + 1, 1);
+			CHECK_EQUAL(next - (long)DS1337::getDays(year, month, 1), Date::daysInMonth(year, month));
+		}
+	}
+}
+
+// arithmetic over the end of February 2100 (no leap day)
+static void testAddDays() {
+	Date d(100, 2, 28, 12, 0, 0);
+	CHECK_EQUAL(28, d.getDaysInMonth());
+	d.addDays(1);
+	CHECK_EQUAL(3, d.getMonth());
+	CHECK_EQUAL(1, d.getDay());
+	d.addDays(-1);
+	CHECK_EQUAL(2, d.getMonth());
+	CHECK_EQUAL(28, d.getDay());
+	Date leap(96, 2, 28, 12, 0, 0);
+	leap.addDays(1);
+	CHECK_EQUAL(29, leap.getDay());
+}
+
+// getDays, getCivil, getTimestamp and getTime agree with timegm from 2000 to the
+// end of 32 bit timestamps (2106-02-07 06:28:15), every day at a varying time
+static void testTimegm() {
+	time_t t2000 = 946684800;
+	unsigned long days = 0;
+	for (time_t day=t2000; day<=(time_t)0xFFFFFFFFUL; day+=SECONDS_PER_DAY, days++) {
+		time_t t = day + (days * 7919) % SECONDS_PER_DAY;
+		if (t > (time_t)0xFFFFFFFFUL)
+			t = 0xFFFFFFFFUL;
+		struct tm tm;
+		gmtime_r(&t, &tm);
+		int year = tm.tm_year - 100;
+		CHECK_EQUAL(days, DS1337::getDays(year, tm.tm_mon + 1, tm.tm_mday));
+		int y, m, d;
+		DS1337::getCivil(days, y, m, d);
+		CHECK_EQUAL(year, y);
+		CHECK_EQUAL(tm.tm_mon + 1, m);
+		CHECK_EQUAL(tm.tm_mday, d);
+		CHECK_EQUAL((unsigned long)timegm(&tm), DS1337::getTimestamp(year, tm.tm_mon + 1, tm.tm_mday, tm.tm_hour, tm.tm_min, tm.tm_sec));
+		int h, mi, sec;
+		DS1337::getTime((unsigned long)t, y, m, d, h, mi, sec);
+		CHECK(y == year && m == tm.tm_mon + 1 && d == tm.tm_mday);
+		CHECK(h == tm.tm_hour && mi == tm.tm_min && sec == tm.tm_sec);
+	}
+	CHECK_EQUAL(DS1337::getDays(106, 2, 7), days - 1);
+}
+
+int main() {
+	testDaysInMonth();
+	testTimegm();
+	testAddDays();
+	return testResult();
+}
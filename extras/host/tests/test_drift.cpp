@@ -0,0 +1,102 @@
+/**
+
+test_drift.cpp
+
+Copyright by Christian Paul, 2014
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+ */
+#include "HostTest.h"
+#include "DS1337Sim.h"
+#include "DS1337Drift.h"
+
+#define T0 1700000000UL
+
+// pairs of a RTC with a drift (ppb) against the reference: one per hour, starting
+// with an offset (ms) of the reference
+static void addPairs(DS1337Drift &drift, unsigned long start, int count, long ppb, long offset) {
+	for (int i=0; i<count; i++) {
+		unsigned long rtc = start + i * 3600UL;
+		// reference - RTC in ms after i hours
+		long ms = offset + (long)((int64_t)i * 3600 * ppb / 1000000);
+		long seconds = ms >= 0 ? ms / 1000 : -((999 - ms) / 1000);
+		drift.addSample(rtc, rtc + seconds, (unsigned int)(ms - seconds * 1000));
+	}
+}
+
+// a RTC slow by 20000 ppb (1.728 s per day)
+static void testSlow(DS1337Drift &drift) {
+	addPairs(drift, T0, 6, 20000, 1500);
+	CHECK_EQUAL(6, drift.count());
+	CHECK_EQUAL(20000L, drift.getDrift());
+	DS1337DriftCoefficients c;
+	drift.getCoefficients(c);
+	CHECK_EQUAL(T0 + 5 * 3600UL, c.origin);
+	CHECK_EQUAL(1500L + 5 * 72, c.offset);
+	CHECK_EQUAL(1860L, drift.getOffset(c.origin));
+	// 10 days later the RTC is 17.28 s behind plus the offset
+	CHECK_EQUAL(1860L + 17280, drift.getOffset(c.origin + 864000UL));
+	CHECK_EQUAL(c.origin + 864000UL + 19, drift.correct(c.origin + 864000UL));
+}
+
+// a fast RTC, negative offsets, the oldest pairs drop out
+static void testFast(DS1337Drift &drift) {
+	drift.clear();
+	addPairs(drift, T0, 4, 20000, 0);
+	addPairs(drift, T0 + 4 * 3600UL, DS1337_DRIFT_SAMPLES, -5000, -250);
+	CHECK_EQUAL(DS1337_DRIFT_SAMPLES, drift.count());
+	CHECK_EQUAL(-5000L, drift.getDrift());
+	CHECK_EQUAL(-250L - (DS1337_DRIFT_SAMPLES - 1) * 18, drift.getOffset(T0 + (3 + DS1337_DRIFT_SAMPLES) * 3600UL));
+}
+
+// one pair sets the offset only, the drift is kept; coefficients round trip
+static void testCoefficients(DS1337Drift &drift) {
+	drift.clear();
+	drift.addSample(T0, T0 + 2, 0);
+	CHECK_EQUAL(-5000L, drift.getDrift());
+	CHECK_EQUAL(2000L, drift.getOffset(T0));
+	DS1337DriftCoefficients c = { T0, 0, 20000 };
+	drift.setCoefficients(c);
+	CHECK_EQUAL(20000L, drift.getDrift());
+	CHECK_EQUAL(-1728L, drift.getOffset(T0 - 86400UL));
+	CHECK_EQUAL(T0 - 86400UL - 2, drift.correct(T0 - 86400UL));
+}
+
+// the correction applied to the time of the RTC
+static void testCorrected(DS1337Drift &drift, DS1337Sim &sim) {
+	DS1337DriftCoefficients c = { T0, 3000, 20000 };
+	drift.setCoefficients(c);
+	sim.setTimestamp(T0 + 86400UL);
+	CHECK_EQUAL(T0 + 86400UL + 5, drift.correctedTimestamp());
+}
+
+int main() {
+	hostReset();
+	DS1337Sim sim(false);
+	Wire.attach(DS1337_ID, sim);
+	DS1337 rtc;
+	rtc.init();
+	DS1337Drift drift(rtc);
+	testSlow(drift);
+	testFast(drift);
+	testCoefficients(drift);
+	testCorrected(drift, sim);
+	return testResult();
+}
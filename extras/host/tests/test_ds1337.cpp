@@ -0,0 +1,118 @@
+/**
+
+test_ds1337.cpp
+
+Copyright by Christian Paul, 2014
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+ */
+#include "HostTest.h"
+#include "DS1337Sim.h"
+#include "DS1337.h"
+#include "DS3231.h"
+
+// date round trip, running clock and the oscillator stop flag
+static void testDate(DS1337 &rtc, DS1337Sim &sim) {
+	CHECK(rtc.hasStopped());
+	rtc.clearOSF();
+	CHECK(!rtc.hasStopped());
+
+	rtc.setDateTime(19, 12, 31, 23, 59, 58);
+	CHECK_EQUAL(1577836798UL, sim.getTimestamp());
+	hostAdvanceMicros(3000000UL);
+	Date d = rtc.getDate();
+	CHECK_EQUAL(20, d.getYear());
+	CHECK_EQUAL(1, d.getMonth());
+	CHECK_EQUAL(1, d.getDay());
+	CHECK_EQUAL(0, d.getHour());
+	CHECK_EQUAL(1, d.getSeconds());
+	CHECK_EQUAL(1577836801UL, rtc.getTimestamp());
+	CHECK(rtc.isRunning());
+}
+
+// alarm 1 sets A1F in the simulator and the library sees it
+static void testAlarm(DS1337 &rtc, DS1337Sim &sim) {
+	rtc.setDateTime(21, 6, 1, 12, 0, 0);
+	rtc.setAlarm(12, 0, 10);
+	rtc.setAlarmMode(DS1337_ALARM_ON_SECOND_MINUTE_HOUR);
+	rtc.enableAlarm();
+	rtc.clearAlarm();
+	hostAdvanceMicros(9000000UL);
+	CHECK(!rtc.isAlarmActive());
+	hostAdvanceMicros(1000000UL);
+	CHECK(rtc.isAlarmActive());
+	CHECK(sim.isInterrupt(DS1337SIM_INTA));
+	rtc.clearAlarm();
+	CHECK(!rtc.isAlarmActive());
+	CHECK(!sim.isInterrupt(DS1337SIM_INTA));
+}
+
+static void testDS1337() {
+	DS1337Sim sim(false);
+	Wire.attach(DS1337_ID, sim);
+	DS1337 rtc;
+	rtc.init();
+	CHECK(!rtc.hasFeature(DS1337_FEATURE_ALARM_INTCN));
+	testDate(rtc, sim);
+	testAlarm(rtc, sim);
+	rtc.stop();
+	CHECK(!rtc.isRunning());
+	unsigned long timestamp = sim.getTimestamp();
+	hostAdvanceMicros(5000000UL);
+	CHECK_EQUAL(timestamp, rtc.getTimestamp());
+	rtc.start();
+	CHECK(rtc.isRunning());
+	Wire.detach(sim);
+}
+
+static void testDS3231() {
+	DS1337Sim sim(true);
+	Wire.attach(DS1337_ID, sim);
+	DS3231 rtc;
+	rtc.init();
+	CHECK(rtc.hasFeature(DS1337_FEATURE_ALARM_INTCN));
+	testDate(rtc, sim);
+	testAlarm(rtc, sim);
+	sim.setTemperatureQuarters(4 * 31 + 1);
+	CHECK(rtc.startConversion());
+	CHECK(rtc.isConverting());
+	CHECK(!rtc.startConversion());
+	delay(200);
+	CHECK(!rtc.isConverting());
+	CHECK_EQUAL(4 * 31 + 1, rtc.getTemperatureQuarters());
+
+	// below zero the MSB is negative (two's complement), the LSB adds quarters
+	sim.setTemperatureQuarters(-42);
+	CHECK(rtc.startConversion());
+	delay(200);
+	DS1337Snapshot snapshot = rtc.snapshot();
+	CHECK(snapshot.hasTemperature());
+	CHECK_EQUAL(-42, snapshot.getTemperatureQuarters());
+	CHECK(snapshot.getTemperature() == -10.5);
+	CHECK_EQUAL(-42, rtc.getTemperatureQuarters());
+	Wire.detach(sim);
+}
+
+int main() {
+	hostReset();
+	testDS1337();
+	testDS3231();
+	return testResult();
+}
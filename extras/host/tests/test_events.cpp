@@ -0,0 +1,102 @@
+/**
+
+test_events.cpp
+
+Copyright by Christian Paul, 2014
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+ */
+#include "HostTest.h"
+#include "DS1337Sim.h"
+#include "DS1337.h"
+
+static int handled;
+static unsigned long lastMicros;
+
+static void handler(DS1337Event &event) {
+	CHECK(event.micros >= lastMicros);
+	lastMicros = event.micros;
+	handled++;
+}
+
+// a full queue drops new events and counts them, one slot is always free
+static void testOverflow() {
+	DS1337EventQueue queue;
+	for (int i=0; i<DS1337_EVENT_QUEUE_SIZE-1; i++) {
+		CHECK(queue.push(i & 1 ? DS1337_EVENT_TICK : DS1337_EVENT_ALARM));
+		hostAdvanceMicros(100);
+	}
+	CHECK_EQUAL(DS1337_EVENT_QUEUE_SIZE-1, queue.available());
+	CHECK_EQUAL(0U, queue.getOverflows());
+	CHECK(!queue.push(DS1337_EVENT_ALARM));
+	CHECK(!queue.push(DS1337_EVENT_TICK));
+	CHECK_EQUAL(2U, queue.getOverflows());
+	CHECK_EQUAL(DS1337_EVENT_QUEUE_SIZE-1, queue.available());
+
+	// the oldest events stay, room again after a pop
+	DS1337Event event;
+	CHECK(queue.pop(event));
+	CHECK_EQUAL(DS1337_EVENT_ALARM, event.kind);
+	unsigned long first = event.micros;
+	CHECK(queue.push(DS1337_EVENT_TICK));
+	CHECK(!queue.push(DS1337_EVENT_TICK));
+	CHECK_EQUAL(3U, queue.getOverflows());
+	CHECK(queue.pop(event));
+	CHECK_EQUAL(DS1337_EVENT_TICK, event.kind);
+	CHECK_EQUAL(first + 100, event.micros);
+
+	// wrap around the ring several times
+	for (int i=0; i<3*DS1337_EVENT_QUEUE_SIZE; i++) {
+		CHECK(queue.pop(event));
+		CHECK(queue.push(DS1337_EVENT_ALARM));
+	}
+	CHECK_EQUAL(DS1337_EVENT_QUEUE_SIZE-2, queue.available());
+	CHECK_EQUAL(3U, queue.getOverflows());
+}
+
+// processEvents empties the queue in order and clears the flags of the events
+static void testProcess() {
+	DS1337Sim sim(false);
+	Wire.attach(DS1337_ID, sim);
+	DS1337 rtc;
+	rtc.init();
+	DS1337EventQueue queue;
+	sim.poke(DS1337SIM_STATUS, DS1337SIM_A1F | DS1337SIM_A2F);
+	for (int i=0; i<DS1337_EVENT_QUEUE_SIZE; i++) {
+		queue.push(DS1337_EVENT_ALARM);
+		hostAdvanceMicros(10);
+	}
+	CHECK_EQUAL(1U, queue.getOverflows());
+	handled = 0;
+	lastMicros = 0;
+	CHECK_EQUAL(DS1337_EVENT_QUEUE_SIZE-1, rtc.processEvents(queue, handler));
+	CHECK_EQUAL(DS1337_EVENT_QUEUE_SIZE-1, handled);
+	CHECK_EQUAL(0, queue.available());
+	CHECK_EQUAL(DS1337SIM_A2F, sim.peek(DS1337SIM_STATUS) & (DS1337SIM_A1F | DS1337SIM_A2F));
+	CHECK_EQUAL(0, rtc.processEvents(queue, handler));
+	Wire.detach(sim);
+}
+
+int main() {
+	hostReset();
+	testOverflow();
+	testProcess();
+	return testResult();
+}
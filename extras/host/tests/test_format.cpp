@@ -0,0 +1,103 @@
+/**
+
+test_format.cpp
+
+Copyright by Christian Paul, 2014
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+ */
+#include "HostTest.h"
+#include <string.h>
+#include "DS1337.h"
+
+// Print into a string
+class StringPrint : public Print {
+	public:
+		char text[64];
+		size_t size;
+
+		StringPrint() {
+			size = 0;
+			text[0] = 0;
+		}
+		size_t write(uint8_t c) {
+			if (size >= sizeof(text) - 1)
+				return 0;
+			text[size++] = c;
+			text[size] = 0;
+			return 1;
+		}
+};
+
+// fixed formats with leading zeros
+static void testFixed() {
+	Date d(7, 3, 9, 4, 5, 6);
+	char buffer[DS1337_ISO8601_SIZE];
+	CHECK(strcmp(d.formatTime(buffer), "04:05:06") == 0);
+	CHECK(strcmp(d.formatDate(buffer), "07-03-09") == 0);
+	CHECK(strcmp(d.formatISO8601(buffer), "2007-03-09T04:05:06") == 0);
+	CHECK(strcmp(d.formatCompact(buffer), "20070309040506") == 0);
+	CHECK(d.getTimeString() == "04:05:06");
+	CHECK(d.getDateString() == "07-03-09");
+	Date e(99, 12, 31, 23, 59, 59);
+	CHECK(strcmp(e.formatISO8601(buffer), "2099-12-31T23:59:59") == 0);
+	CHECK_EQUAL(DS1337_ISO8601_SIZE - 1, (int)strlen(buffer));
+}
+
+// placeholders in a pattern, other characters copied
+static void testPattern() {
+	Date d(21, 11, 2, 13, 8, 0);
+	char buffer[32];
+	CHECK_EQUAL(16, d.format(buffer, sizeof(buffer), "DD.MM.YYYY hh:mm"));
+	CHECK(strcmp(buffer, "02.11.2021 13:08") == 0);
+	CHECK_EQUAL(12, d.format(buffer, sizeof(buffer), "log_YYMMDD.t"));
+	CHECK(strcmp(buffer, "log_211102.t") == 0);
+	CHECK_EQUAL(9, d.format(buffer, sizeof(buffer), "Y M D h:s"));
+	CHECK(strcmp(buffer, "Y M D h:s") == 0);
+	CHECK_EQUAL(0, d.format(buffer, sizeof(buffer), ""));
+	CHECK(strcmp(buffer, "") == 0);
+	StringPrint out;
+	CHECK_EQUAL(19u, d.print(out, "YYYY-MM-DD hh:mm:ss"));
+	CHECK(strcmp(out.text, "2021-11-02 13:08:00") == 0);
+}
+
+// a buffer too small gets the truncated string, nothing is written behind it
+static void testSmallBuffer() {
+	Date d(21, 11, 2, 13, 8, 0);
+	char buffer[16];
+	memset(buffer, '#', sizeof(buffer));
+	CHECK_EQUAL(6, d.format(buffer, 7, "YYYY-MM-DD"));
+	CHECK(strcmp(buffer, "2021-1") == 0);
+	CHECK_EQUAL('#', buffer[7]);
+	memset(buffer, '#', sizeof(buffer));
+	CHECK_EQUAL(0, d.format(buffer, 1, "hh:mm"));
+	CHECK_EQUAL(0, buffer[0]);
+	CHECK_EQUAL('#', buffer[1]);
+	memset(buffer, '#', sizeof(buffer));
+	CHECK_EQUAL(0, d.format(buffer, 0, "hh:mm"));
+	CHECK_EQUAL('#', buffer[0]);
+}
+
+int main() {
+	testFixed();
+	testPattern();
+	testSmallBuffer();
+	return testResult();
+}
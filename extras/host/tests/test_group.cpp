@@ -0,0 +1,109 @@
+/**
+
+test_group.cpp
+
+Copyright by Christian Paul, 2014
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+ */
+#include "HostTest.h"
+#include "DS1337Sim.h"
+#include "DS1337Transport.h"
+#include "DS1337Group.h"
+#include "DS3231.h"
+
+#define T0 1700000000UL
+
+int main() {
+	hostReset();
+	WireMux wireMux;
+	DS1337Sim sims[4] = { DS1337Sim(false), DS1337Sim(false), DS1337Sim(true), DS1337Sim(true) };
+	Wire.attach(DS1337_TCA9548A_ID, wireMux);
+	for (int i=0; i<4; i++)
+		Wire.attach(DS1337_ID, sims[i], wireMux, i);
+
+	// four RTCs with the same address, each on its own channel
+	DS1337Mux mux(DS1337Wire);
+	DS1337MuxTransport t0(mux, 0), t1(mux, 1), t2(mux, 2), t3(mux, 3);
+	DS1337 rtc0(t0), rtc1(t1);
+	DS3231 rtc2(t2), rtc3(t3);
+	DS1337 *rtcs[4] = { &rtc0, &rtc1, &rtc2, &rtc3 };
+	DS1337Group group;
+	for (int i=0; i<4; i++) {
+		rtcs[i]->init();
+		CHECK_EQUAL(i, group.add(*rtcs[i]));
+	}
+	CHECK_EQUAL(19, rtc2.getRegisterCount());
+	CHECK_EQUAL(16, rtc0.getRegisterCount());
+
+	// RTC 1 is 10 seconds ahead, RTC 3 lost its time (OSF)
+	sims[0].setTimestamp(T0);
+	sims[1].setTimestamp(T0 + 10);
+	sims[2].setTimestamp(T0);
+	sims[3].setTimestamp(T0);
+	for (int i=0; i<3; i++)
+		rtcs[i]->clearOSF();
+	CHECK_EQUAL(0, Wire.getCollisions());
+
+	unsigned long selects = mux.getSelects();
+	group.update();
+	CHECK_EQUAL(selects + 4, mux.getSelects());
+	CHECK_EQUAL(0, Wire.getCollisions());
+	CHECK(!group.hasConsensus());
+	CHECK_EQUAL(T0, group.getTimestamp());
+	CHECK(group.isValid(0));
+	CHECK(group.isOutlier(1));
+	CHECK_EQUAL(10, group.getOffset(1));
+	CHECK(!group.isOutlier(2));
+	CHECK(!group.isValid(3));
+	CHECK_EQUAL(2, group.getOutliers());
+
+	// the bus time of the model matches the simulated bus (channel already selected)
+	unsigned long start = micros();
+	rtc0.snapshot();
+	CHECK_EQUAL(micros() - start, group.getBusMicros(0) + DS1337Transport::getBusMicros(1, 2, DS1337_I2C_STANDARD_MODE));
+	start = micros();
+	rtc0.snapshot();
+	CHECK_EQUAL(micros() - start, group.getBusMicros(0));
+	CHECK(group.getBusMicros(2) > group.getBusMicros(0));
+
+	// RTC 3 set again: three of four agree; all valid RTCs moved on by the same time
+	sims[3].setTimestamp(T0);
+	rtc3.clearOSF();
+	delay(5000);
+	group.update();
+	CHECK(group.hasConsensus());
+	CHECK(group.isValid(3));
+	CHECK_EQUAL(1, group.getOutliers());
+	CHECK_EQUAL(T0 + 5, group.getTimestamp());
+	CHECK_EQUAL(T0 + 15, group.getTimestamp(1));
+
+	// RTC 0 and 2 disconnected: invalid, the two left don't agree
+	Wire.detach(sims[0]);
+	Wire.detach(sims[2]);
+	group.update();
+	CHECK(!group.isValid(0));
+	CHECK(!group.isValid(2));
+	CHECK(group.isValid(1));
+	CHECK(group.isValid(3));
+	CHECK(!group.hasConsensus());
+	CHECK_EQUAL(3, group.getOutliers());
+	return testResult();
+}
@@ -0,0 +1,116 @@
+/**
+
+test_instant.cpp
+
+Copyright by Christian Paul, 2014
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+ */
+#include "HostTest.h"
+#include "DS1337Sim.h"
+#include "DS1337.h"
+
+// DS1337 answering some reads from a second simulator with an older time
+// (e.g. a disturbed transfer), writes go to both
+class GlitchSim : public WireDevice {
+	public:
+		DS1337Sim rtc;
+		DS1337Sim stale;
+		int glitches;
+
+		GlitchSim() {
+			glitches = 0;
+		}
+		bool receive(const uint8_t *data, size_t count) {
+			stale.receive(data, count);
+			return rtc.receive(data, count);
+		}
+		size_t transmit(uint8_t *data, size_t count) {
+			if (glitches > 0) {
+				glitches--;
+				rtc.transmit(data, count);
+				return stale.transmit(data, count);
+			}
+			stale.transmit(data, count);
+			return rtc.transmit(data, count);
+		}
+};
+
+// date, day of week and timestamp of one burst stay consistent over a rollover
+static void testRollover(DS1337 &rtc, GlitchSim &sim) {
+	rtc.setDateTime(21, 12, 31, 23, 59, 59);
+	rtc.setDayOfWeek(5);
+	Date date;
+	int dayOfWeek;
+	hostAdvanceMicros(sim.rtc.microsToNextSecond() - 2000);
+	unsigned long before = rtc.getInstant(date, dayOfWeek);
+	CHECK_EQUAL(1640995199UL, before);
+	CHECK_EQUAL(31, date.getDay());
+	CHECK_EQUAL(5, dayOfWeek);
+	CHECK(!rtc.hasJumpedBack());
+	hostAdvanceMicros(2000);
+	unsigned long after = rtc.getInstant(date, dayOfWeek);
+	CHECK_EQUAL(before + 1, after);
+	CHECK_EQUAL(22, date.getYear());
+	CHECK_EQUAL(1, date.getMonth());
+	CHECK_EQUAL(1, date.getDay());
+	CHECK_EQUAL(0, date.getSeconds());
+	CHECK_EQUAL(6, dayOfWeek);
+	CHECK(!rtc.hasJumpedBack());
+}
+
+// one read before the previous instant is read again, two mean a jump back
+static void testRetry(DS1337 &rtc, GlitchSim &sim) {
+	Date date;
+	int dayOfWeek;
+	unsigned long previous = rtc.getInstant(date, dayOfWeek);
+	sim.stale.setTimestamp(previous - 1);
+	sim.glitches = 1;
+	Wire.resetStatistics();
+	CHECK_EQUAL(previous, rtc.getInstant(date, dayOfWeek));
+	CHECK(!rtc.hasJumpedBack());
+	CHECK_EQUAL(4UL, Wire.getTransactions());
+	CHECK_EQUAL(0, sim.glitches);
+
+	// without a glitch a single read
+	Wire.resetStatistics();
+	rtc.getInstant(date, dayOfWeek);
+	CHECK_EQUAL(2UL, Wire.getTransactions());
+
+	// the time really went back
+	previous = rtc.getInstant(date, dayOfWeek);
+	sim.rtc.setTimestamp(previous - 3600);
+	sim.stale.setTimestamp(previous - 3600);
+	CHECK_EQUAL(previous - 3600, rtc.getInstant(date, dayOfWeek));
+	CHECK(rtc.hasJumpedBack());
+	CHECK_EQUAL(previous - 3600, rtc.getInstant(date, dayOfWeek));
+	CHECK(!rtc.hasJumpedBack());
+}
+
+int main() {
+	hostReset();
+	GlitchSim sim;
+	Wire.attach(DS1337_ID, sim);
+	DS1337 rtc;
+	rtc.init();
+	testRollover(rtc, sim);
+	testRetry(rtc, sim);
+	return testResult();
+}
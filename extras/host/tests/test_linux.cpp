@@ -0,0 +1,152 @@
+/**
+
+test_linux.cpp
+
+Copyright by Christian Paul, 2014
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+ */
+#include "HostTest.h"
+#include "DS1337LinuxTransport.h"
+#include "DS1337.h"
+#include <linux/i2c.h>
+
+// in-process fake of i2c-dev: records the messages of the last I2C_RDWR and
+// answers from a register array (a write message sets the pointer and data)
+class FakeLinuxTransport : public DS1337LinuxTransport {
+	public:
+		int calls;
+		int lastCount;
+		struct i2c_msg last[2];
+		byte lastData[2][32];
+		int result;
+		byte reg[DS1337_MAX_REGISTERS];
+
+		FakeLinuxTransport() : DS1337LinuxTransport(-1) {
+			calls = 0;
+			lastCount = 0;
+			result = -2;
+			_fakePointer = 0;
+			memset(reg, 0, sizeof(reg));
+		}
+	protected:
+		int transfer(struct i2c_msg *messages, int count) {
+			calls++;
+			lastCount = count;
+			for (int i=0; i<count && i<2; i++) {
+				last[i] = messages[i];
+				if (!(messages[i].flags & I2C_M_RD))
+					memcpy(lastData[i], messages[i].buf, messages[i].len);
+			}
+			for (int i=0; i<count; i++) {
+				struct i2c_msg &m = messages[i];
+				if (m.flags & I2C_M_RD) {
+					for (int j=0; j<m.len; j++)
+						m.buf[j] = reg[(_fakePointer++) % DS1337_MAX_REGISTERS];
+				}
+				else if (m.len > 0) {
+					_fakePointer = m.buf[0];
+					for (int j=1; j<m.len; j++)
+						reg[(_fakePointer++) % DS1337_MAX_REGISTERS] = m.buf[j];
+				}
+			}
+			// -2: all messages transferred
+			return result == -2 ? count : result;
+		}
+	private:
+		byte _fakePointer;
+};
+
+// a read is one write message (register pointer) and one read message, combined
+static void testRead() {
+	FakeLinuxTransport transport;
+	transport.reg[3] = 0x42;
+	transport.reg[4] = 0x17;
+	byte data[2];
+	CHECK_EQUAL(2, transport.read(DS1337_ID, 3, data, 2));
+	CHECK_EQUAL(1, transport.calls);
+	CHECK_EQUAL(2, transport.lastCount);
+	CHECK_EQUAL(DS1337_ID, transport.last[0].addr);
+	CHECK_EQUAL(0, transport.last[0].flags);
+	CHECK_EQUAL(1, transport.last[0].len);
+	CHECK_EQUAL(3, transport.lastData[0][0]);
+	CHECK_EQUAL(DS1337_ID, transport.last[1].addr);
+	CHECK_EQUAL(I2C_M_RD, transport.last[1].flags);
+	CHECK_EQUAL(2, transport.last[1].len);
+	CHECK_EQUAL(0x42, data[0]);
+	CHECK_EQUAL(0x17, data[1]);
+
+	// only one message transferred, or an error: nothing read
+	transport.result = 1;
+	CHECK_EQUAL(0, transport.read(DS1337_ID, 3, data, 2));
+	transport.result = -1;
+	CHECK_EQUAL(0, transport.read(DS1337_ID, 3, data, 2));
+	CHECK_EQUAL(0, transport.receive(DS1337_ID, data, 2));
+	CHECK_EQUAL(0, transport.point(DS1337_ID, 3));
+}
+
+// a write is one message: register pointer followed by the data
+static void testWrite() {
+	FakeLinuxTransport transport;
+	const byte data[3] = { 0x11, 0x22, 0x33 };
+	CHECK_EQUAL(3, transport.write(DS1337_ID, 7, data, 3));
+	CHECK_EQUAL(1, transport.lastCount);
+	CHECK_EQUAL(0, transport.last[0].flags);
+	CHECK_EQUAL(4, transport.last[0].len);
+	CHECK_EQUAL(7, transport.lastData[0][0]);
+	CHECK_EQUAL(0x11, transport.lastData[0][1]);
+	CHECK_EQUAL(0x33, transport.lastData[0][3]);
+	CHECK_EQUAL(0x22, transport.reg[8]);
+	transport.result = 0;
+	CHECK_EQUAL(0, transport.write(DS1337_ID, 7, data, 3));
+}
+
+// the cost model counts one transaction with a repeated start per read
+static void testCost() {
+	FakeLinuxTransport transport;
+	CHECK_EQUAL(1, transport.getReadTransactions());
+	CHECK_EQUAL(2, DS1337Wire.getReadTransactions());
+	// 2 starts, 1 stop, 10 bytes at 100 kHz
+	CHECK_EQUAL(930, transport.getReadMicros(DS1337_REGISTERS_DATE));
+	CHECK_EQUAL(940, DS1337Wire.getReadMicros(DS1337_REGISTERS_DATE));
+}
+
+// the library on the fake: a date read is a single I2C_RDWR
+static void testDS1337() {
+	FakeLinuxTransport transport;
+	DS1337 rtc(transport);
+	rtc.init();
+	rtc.setDateTime(24, 3, 7, 9, 5, 30);
+	CHECK_EQUAL(0x30, transport.reg[DS1337_SECONDS]);
+	CHECK_EQUAL(0x24, transport.reg[DS1337_YEAR]);
+	int calls = transport.calls;
+	Date d = rtc.getDate();
+	CHECK_EQUAL(calls + 1, transport.calls);
+	CHECK_EQUAL(24, d.getYear());
+	CHECK_EQUAL(5, d.getMinutes());
+}
+
+int main() {
+	testRead();
+	testWrite();
+	testCost();
+	testDS1337();
+	return testResult();
+}
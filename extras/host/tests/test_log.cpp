@@ -0,0 +1,141 @@
+/**
+
+test_log.cpp
+
+Copyright by Christian Paul, 2014
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+ */
+#include "HostTest.h"
+#include "DS1337Log.h"
+
+// Print into a buffer, accepts only up to a limit (e.g. a full SD card)
+class BufferPrint : public Print {
+	public:
+		byte buffer[1024];
+		size_t size;
+		size_t limit;
+
+		BufferPrint() {
+			size = 0;
+			limit = sizeof(buffer);
+		}
+		size_t write(uint8_t c) {
+			if (size >= limit)
+				return 0;
+			buffer[size++] = c;
+			return 1;
+		}
+};
+
+#define T0 1700000000UL
+
+// every record decodes to its timestamp and payload, an absolute record starts
+// every sync interval, the first byte of a delta record is never the tag
+static void testRoundTrip() {
+	BufferPrint out;
+	DS1337LogWriter writer(out);
+	writer.setSyncInterval(4);
+	size_t start[10];
+	unsigned long timestamps[10];
+	unsigned long t = T0;
+	for (int i=0; i<10; i++) {
+		byte payload[3] = { (byte)i, 0x01, (byte)(i * 7) };
+		start[i] = out.size;
+		timestamps[i] = t;
+		CHECK(writer.write(t, payload, i % 4) > 0);
+		t += 1 + i * 100;
+	}
+	CHECK_EQUAL(10, writer.getRecords());
+	CHECK_EQUAL(out.size, writer.getBytes());
+	for (int i=0; i<10; i++)
+		CHECK_EQUAL(i % 4 == 0, out.buffer[start[i]] == DS1337_LOG_ABSOLUTE);
+
+	DS1337LogReader reader(out.buffer, out.size);
+	DS1337LogRecord record;
+	for (int i=0; i<10; i++) {
+		CHECK(reader.next(record));
+		CHECK_EQUAL(timestamps[i], record.timestamp);
+		CHECK_EQUAL(i % 4, record.length);
+		if (record.length > 0)
+			CHECK_EQUAL(i, record.data[0]);
+		if (record.length > 2)
+			CHECK_EQUAL(i * 7, record.data[2]);
+	}
+	CHECK(!reader.next(record));
+	CHECK(!reader.hasError());
+
+	// time going back is written as absolute record
+	size_t back = out.size;
+	writer.write(T0, NULL, 0);
+	CHECK_EQUAL(DS1337_LOG_ABSOLUTE, out.buffer[back]);
+	DS1337LogReader tail(out.buffer + back, out.size - back);
+	CHECK(tail.next(record));
+	CHECK_EQUAL(T0, record.timestamp);
+	CHECK(tail.getPosition() == out.size - back);
+}
+
+// a partial write isn't counted, the next record is absolute again
+static void testPartialWrite() {
+	BufferPrint out;
+	DS1337LogWriter writer(out);
+	byte payload[8] = { 1, 2, 3, 4, 5, 6, 7, 8 };
+	CHECK_EQUAL(8 + 6, writer.write(T0, payload, 8));
+	out.limit = out.size + 4;
+	CHECK_EQUAL(4, writer.write(T0 + 10, payload, 8));
+	CHECK_EQUAL(1, writer.getRecords());
+	// the card has room again, the broken record is dropped by the host
+	out.size -= 4;
+	out.limit = sizeof(out.buffer);
+	size_t start = out.size;
+	CHECK_EQUAL(8 + 6, writer.write(T0 + 20, payload, 8));
+	CHECK_EQUAL(DS1337_LOG_ABSOLUTE, out.buffer[start]);
+	CHECK_EQUAL(2, writer.getRecords());
+	DS1337LogReader reader(out.buffer, out.size);
+	DS1337LogRecord record;
+	CHECK(reader.next(record));
+	CHECK(reader.next(record));
+	CHECK_EQUAL(T0 + 20, record.timestamp);
+	CHECK(!reader.next(record));
+}
+
+// truncated records and a delta before the first absolute record are errors
+static void testErrors() {
+	BufferPrint out;
+	DS1337LogWriter writer(out);
+	byte payload[4] = { 1, 2, 3, 4 };
+	writer.write(T0, payload, 4);
+	writer.write(T0 + 1, payload, 4);
+	DS1337LogReader truncated(out.buffer, out.size - 1);
+	DS1337LogRecord record;
+	CHECK(truncated.next(record));
+	CHECK(!truncated.next(record));
+	CHECK(truncated.hasError());
+	DS1337LogReader unsynced(out.buffer + 10, out.size - 10);
+	CHECK(!unsynced.next(record));
+	CHECK(unsynced.hasError());
+}
+
+int main() {
+	testRoundTrip();
+	testPartialWrite();
+	testErrors();
+	return testResult();
+}
@@ -0,0 +1,72 @@
+/**
+
+test_packed.cpp
+
+Copyright by Christian Paul, 2014
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+ */
+#include "HostTest.h"
+#include "DS1337PackedDate.h"
+
+#define T2064 2966371200UL
+
+// pack/unpack round trips and time order over the whole range (sampled)
+static void testRoundTrip() {
+	PackedDate previous;
+	PackedDate40 previous40;
+	for (unsigned long t=T2000UTC; t<T2064; t+=86400UL*7+3661UL) {
+		PackedDate p = PackedDate::fromTimestamp(t);
+		CHECK_EQUAL(t, p.getTimestamp());
+		Date d = p.toDate();
+		CHECK(PackedDate(d) == p);
+		CHECK(previous < p);
+		previous = p;
+		PackedDate40 p40 = PackedDate40::fromTimestamp(t, 500);
+		CHECK_EQUAL(t, p40.getTimestamp());
+		CHECK_EQUAL(128, p40.getFraction());
+		CHECK(previous40 < p40);
+		previous40 = p40;
+	}
+	CHECK(PackedDate40::fromTimestamp(T2000UTC, 1) < PackedDate40::fromTimestamp(T2000UTC, 10));
+}
+
+// years from 2064 on are clamped to the last packed second, not wrapped to 2000
+static void testRange() {
+	PackedDate last(63, 12, 31, 23, 59, 59);
+	CHECK_EQUAL(DS1337_PACKED_MAX, last.getValue());
+	CHECK_EQUAL(63, last.getYear());
+	CHECK_EQUAL(12, last.getMonth());
+	CHECK_EQUAL(31, last.getDay());
+	CHECK_EQUAL(T2064 - 1, last.getTimestamp());
+	PackedDate later(64, 1, 1, 0, 0, 0);
+	CHECK(later == last);
+	CHECK(PackedDate(63, 1, 1, 0, 0, 0) < later);
+	CHECK(PackedDate::fromTimestamp(T2064) == last);
+	CHECK(PackedDate(99, 12, 31, 23, 59, 59) == last);
+	CHECK(PackedDate(-1, 1, 1, 0, 0, 0) <= PackedDate(0, 1, 1, 0, 0, 0));
+	CHECK(PackedDate40::fromTimestamp(T2064).getDate() == last);
+}
+
+int main() {
+	testRoundTrip();
+	testRange();
+	return testResult();
+}
@@ -0,0 +1,152 @@
+/**
+
+test_parse.cpp
+
+Copyright by Christian Paul, 2014
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+ */
+#include <string.h>
+#include "HostTest.h"
+#include "DS1337Sim.h"
+#include "DS1337.h"
+
+static int timeOf(const char *text, int &hour, int &minutes, int &seconds) {
+	return DS1337::parseTime(text, strlen(text), hour, minutes, seconds);
+}
+
+static int dateOf(const char *text, int &year, int &month, int &day) {
+	return DS1337::parseDate(text, strlen(text), year, month, day);
+}
+
+static int dateTimeOf(const char *text, int &year, int &month, int &day, int &hour, int &minutes, int &seconds) {
+	return DS1337::parseDateTime(text, strlen(text), year, month, day, hour, minutes, seconds);
+}
+
+static int alarmOf(const char *text, int &day, int &hour, int &minutes) {
+	return DS1337::parseAlarm(text, strlen(text), day, hour, minutes);
+}
+
+static void testTime() {
+	int h, mi, s;
+	CHECK_EQUAL(DS1337_PARSE_OK, timeOf("09:05:30", h, mi, s));
+	CHECK_EQUAL(9, h);
+	CHECK_EQUAL(5, mi);
+	CHECK_EQUAL(30, s);
+	CHECK_EQUAL(DS1337_PARSE_OK, timeOf(" 23:59 ", h, mi, s));
+	CHECK_EQUAL(23, h);
+	CHECK_EQUAL(0, s);
+	CHECK_EQUAL(DS1337_PARSE_RANGE, timeOf("24:00", h, mi, s));
+	CHECK_EQUAL(DS1337_PARSE_RANGE, timeOf("12:60:00", h, mi, s));
+	CHECK_EQUAL(DS1337_PARSE_RANGE, timeOf("12:00:60", h, mi, s));
+	CHECK_EQUAL(DS1337_PARSE_FORMAT, timeOf("09:05:30x", h, mi, s));
+	CHECK_EQUAL(DS1337_PARSE_FORMAT, timeOf("9:05", h, mi, s));
+	CHECK_EQUAL(DS1337_PARSE_FORMAT, timeOf("09:5a", h, mi, s));
+	CHECK_EQUAL(DS1337_PARSE_FORMAT, timeOf("", h, mi, s));
+	// a buffer cut off within the seconds
+	CHECK_EQUAL(DS1337_PARSE_FORMAT, DS1337::parseTime("09:05:30", 7, h, mi, s));
+}
+
+static void testDate() {
+	int y, mo, d;
+	CHECK_EQUAL(DS1337_PARSE_OK, dateOf("2024-02-29", y, mo, d));
+	CHECK_EQUAL(24, y);
+	CHECK_EQUAL(2, mo);
+	CHECK_EQUAL(29, d);
+	CHECK_EQUAL(DS1337_PARSE_OK, dateOf("99.12.31", y, mo, d));
+	CHECK_EQUAL(99, y);
+	CHECK_EQUAL(DS1337_PARSE_RANGE, dateOf("2023-02-29", y, mo, d));
+	CHECK_EQUAL(DS1337_PARSE_RANGE, dateOf("2100-02-28", y, mo, d));
+	CHECK_EQUAL(DS1337_PARSE_RANGE, dateOf("24-13-01", y, mo, d));
+	CHECK_EQUAL(DS1337_PARSE_RANGE, dateOf("24-04-31", y, mo, d));
+	CHECK_EQUAL(DS1337_PARSE_RANGE, dateOf("24-01-00", y, mo, d));
+	CHECK_EQUAL(DS1337_PARSE_FORMAT, dateOf("2024-02-29x", y, mo, d));
+	CHECK_EQUAL(DS1337_PARSE_FORMAT, dateOf("2024-2-29", y, mo, d));
+	CHECK_EQUAL(DS1337_PARSE_FORMAT, DS1337::parseDate("2024-02-29", 9, y, mo, d));
+}
+
+static void testDateTime() {
+	int y, mo, d, h, mi, s;
+	CHECK_EQUAL(DS1337_PARSE_OK, dateTimeOf("2024-03-07T09:05:30Z", y, mo, d, h, mi, s));
+	CHECK_EQUAL(24, y);
+	CHECK_EQUAL(3, mo);
+	CHECK_EQUAL(7, d);
+	CHECK_EQUAL(9, h);
+	CHECK_EQUAL(5, mi);
+	CHECK_EQUAL(30, s);
+	CHECK_EQUAL(DS1337_PARSE_OK, dateTimeOf("2024-03-07 09:05:30", y, mo, d, h, mi, s));
+	CHECK_EQUAL(DS1337_PARSE_OK, dateTimeOf("24-03-07 09:05", y, mo, d, h, mi, s));
+	CHECK_EQUAL(0, s);
+	CHECK_EQUAL(DS1337_PARSE_OK, dateTimeOf("20240307090530", y, mo, d, h, mi, s));
+	CHECK_EQUAL(30, s);
+	CHECK_EQUAL(DS1337_PARSE_OK, dateTimeOf("1709802330", y, mo, d, h, mi, s));
+	CHECK_EQUAL(24, y);
+	CHECK_EQUAL(9, h);
+	CHECK_EQUAL(30, s);
+	CHECK_EQUAL(DS1337_PARSE_RANGE, dateTimeOf("2023-02-29T00:00:00", y, mo, d, h, mi, s));
+	CHECK_EQUAL(DS1337_PARSE_RANGE, dateTimeOf("2024-03-07T25:00:00", y, mo, d, h, mi, s));
+	CHECK_EQUAL(DS1337_PARSE_RANGE, dateTimeOf("20230229000000", y, mo, d, h, mi, s));
+	CHECK_EQUAL(DS1337_PARSE_RANGE, dateTimeOf("946684799", y, mo, d, h, mi, s));
+	CHECK_EQUAL(DS1337_PARSE_RANGE, dateTimeOf("5000000000", y, mo, d, h, mi, s));
+	CHECK_EQUAL(DS1337_PARSE_FORMAT, dateTimeOf("2024-03-07T09:05:30+01", y, mo, d, h, mi, s));
+	CHECK_EQUAL(DS1337_PARSE_FORMAT, dateTimeOf("2024-03-07X09:05:30", y, mo, d, h, mi, s));
+	CHECK_EQUAL(DS1337_PARSE_FORMAT, dateTimeOf("2024-03-07 09:05:30 ok", y, mo, d, h, mi, s));
+	CHECK_EQUAL(DS1337_PARSE_FORMAT, DS1337::parseDateTime("2024-03-07 09:05:30", 16, y, mo, d, h, mi, s));
+}
+
+static void testAlarm() {
+	int d, h, mi;
+	CHECK_EQUAL(DS1337_PARSE_OK, alarmOf("07:30", d, h, mi));
+	CHECK_EQUAL(-1, d);
+	CHECK_EQUAL(7, h);
+	CHECK_EQUAL(30, mi);
+	CHECK_EQUAL(DS1337_PARSE_OK, alarmOf("15.07:30", d, h, mi));
+	CHECK_EQUAL(15, d);
+	CHECK_EQUAL(DS1337_PARSE_RANGE, alarmOf("32.07:30", d, h, mi));
+	CHECK_EQUAL(DS1337_PARSE_RANGE, alarmOf("00.07:30", d, h, mi));
+	CHECK_EQUAL(DS1337_PARSE_RANGE, alarmOf("15.24:00", d, h, mi));
+	CHECK_EQUAL(DS1337_PARSE_FORMAT, alarmOf("15.07:30:00", d, h, mi));
+	CHECK_EQUAL(DS1337_PARSE_FORMAT, alarmOf("1x.07:30", d, h, mi));
+	CHECK_EQUAL(DS1337_PARSE_FORMAT, DS1337::parseAlarm("15.07:30", 6, d, h, mi));
+}
+
+// a rejected text leaves the RTC unchanged
+static void testSetter() {
+	DS1337Sim sim(false);
+	Wire.attach(DS1337_ID, sim);
+	DS1337 rtc;
+	rtc.init();
+	CHECK_EQUAL(DS1337_PARSE_OK, rtc.setDateTime("2024-03-07 09:05:30"));
+	CHECK_EQUAL(1709802330UL, sim.getTimestamp());
+	CHECK_EQUAL(DS1337_PARSE_RANGE, rtc.setDateTime("2023-02-29 09:05:30"));
+	CHECK_EQUAL(DS1337_PARSE_FORMAT, rtc.setTime("09:05:3"));
+	CHECK_EQUAL(1709802330UL, sim.getTimestamp());
+	Wire.detach(sim);
+}
+
+int main() {
+	hostReset();
+	testTime();
+	testDate();
+	testDateTime();
+	testAlarm();
+	testSetter();
+	return testResult();
+}
@@ -0,0 +1,97 @@
+/**
+
+test_scheduler.cpp
+
+Copyright by Christian Paul, 2014
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+ */
+#include "HostTest.h"
+#include "DS1337Sim.h"
+#include "DS1337Scheduler.h"
+
+#define T0 1700000000UL
+
+static DS1337Alarm fired[DS1337_SCHEDULER_SIZE];
+static int firedCount = 0;
+
+static void onAlarm(DS1337Alarm &alarm) {
+	if (firedCount < DS1337_SCHEDULER_SIZE)
+		fired[firedCount] = alarm;
+	firedCount++;
+}
+
+// remove all entries of an id, also one moved up by the replacement of another
+static void testRemove(DS1337Scheduler &scheduler, DS1337Sim &sim) {
+	// heap {10:A, 40:B, 20:C, 50:X, 45, 30, 35:X}
+	const unsigned long offsets[] = { 10, 40, 20, 50, 45, 30, 35 };
+	const byte ids[] = { 1, 2, 3, 9, 4, 5, 9 };
+	for (int i=0; i<7; i++)
+		CHECK(scheduler.add(T0 + offsets[i], ids[i]));
+	CHECK(scheduler.remove(9));
+	CHECK_EQUAL(5, scheduler.count());
+	CHECK(!scheduler.remove(9));
+
+	DS1337Alarm next;
+	CHECK(scheduler.peek(next));
+	CHECK_EQUAL(T0 + 10, next.timestamp);
+
+	// all remaining alarms fire in time order, none with the removed id
+	sim.setTimestamp(T0 + 60);
+	firedCount = 0;
+	CHECK_EQUAL(5, scheduler.process(onAlarm));
+	CHECK_EQUAL(5, firedCount);
+	for (int i=0; i<firedCount; i++) {
+		CHECK(fired[i].id != 9);
+		if (i > 0)
+			CHECK(fired[i - 1].timestamp <= fired[i].timestamp);
+	}
+	CHECK_EQUAL(0, scheduler.count());
+}
+
+// removing the earliest alarm re-arms alarm 1 with the next one
+static void testRearm(DS1337 &rtc, DS1337Scheduler &scheduler, DS1337Sim &sim) {
+	sim.setTimestamp(T0);
+	CHECK(scheduler.add(T0 + 5, 1));
+	CHECK(scheduler.add(T0 + 8, 2));
+	CHECK(scheduler.remove(1));
+	hostAdvanceMicros(6000000UL);
+	CHECK(!rtc.isAlarmActive());
+	hostAdvanceMicros(2000000UL);
+	CHECK(rtc.isAlarmActive());
+	firedCount = 0;
+	CHECK_EQUAL(1, scheduler.process(onAlarm));
+	CHECK_EQUAL(2, fired[0].id);
+	CHECK(!scheduler.remove(2));
+}
+
+int main() {
+	hostReset();
+	DS1337Sim sim(false);
+	Wire.attach(DS1337_ID, sim);
+	sim.setTimestamp(T0);
+	DS1337 rtc;
+	rtc.init();
+	DS1337Scheduler scheduler(rtc);
+	scheduler.begin();
+	testRemove(scheduler, sim);
+	testRearm(rtc, scheduler, sim);
+	return testResult();
+}
@@ -0,0 +1,259 @@
+/**
+
+test_sim.cpp
+
+Copyright by Christian Paul, 2014
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+ */
+#include "HostTest.h"
+#include "DS1337Sim.h"
+
+// read registers over the bus
+static void readRegisters(uint8_t reg, uint8_t *data, uint8_t count) {
+	Wire.beginTransmission(0x68);
+	Wire.write(reg);
+	Wire.endTransmission();
+	Wire.requestFrom((uint8_t)0x68, count);
+	for (uint8_t i=0; i<count; i++)
+		data[i] = (uint8_t)Wire.read();
+}
+
+// write one register over the bus
+static void writeRegister(uint8_t reg, uint8_t value) {
+	Wire.beginTransmission(0x68);
+	Wire.write(reg);
+	Wire.write(value);
+	Wire.endTransmission();
+}
+
+static uint8_t readRegister(uint8_t reg) {
+	uint8_t value;
+	readRegisters(reg, &value, 1);
+	return value;
+}
+
+// oscillator and calendar carry over month, leap day and year
+static void testCalendar(DS1337Sim &rtc) {
+	rtc.setDateTime(2024, 2, 28, 23, 59, 59);
+	hostAdvanceMicros(1000000UL);
+	uint8_t r[7];
+	readRegisters(0, r, 7);
+	CHECK_EQUAL(0x00, r[0]);
+	CHECK_EQUAL(0x00, r[2]);
+	CHECK_EQUAL(0x29, r[4]);
+	CHECK_EQUAL(0x02, r[5]);
+	CHECK_EQUAL(4, r[3]);
+
+	rtc.setDateTime(2099, 12, 31, 23, 59, 59);
+	hostAdvanceMicros(1000000UL);
+	readRegisters(0, r, 7);
+	CHECK_EQUAL(0x01, r[4]);
+	CHECK_EQUAL(0x81, r[5]);
+	CHECK_EQUAL(0x00, r[6]);
+
+	rtc.setTimestamp(1700000000UL);
+	CHECK_EQUAL(1700000000UL, rtc.getTimestamp());
+	hostAdvanceMicros(3600UL * 1000000UL);
+	CHECK_EQUAL(1700003600UL, rtc.getTimestamp());
+}
+
+// register pointer auto increment and wrap around
+static void testPointer(DS1337Sim &rtc) {
+	uint8_t r[3];
+	readRegisters(rtc.getRegisterCount() - 1, r, 3);
+	CHECK_EQUAL(rtc.peek(0), r[1]);
+	CHECK_EQUAL(2, rtc.getPointer());
+}
+
+// alarm 1 on seconds, alarm 2 every minute, flags are cleared by writing 0
+static void testAlarms(DS1337Sim &rtc) {
+	rtc.setDateTime(2020, 5, 1, 10, 0, 50);
+	writeRegister(0x07, 0x55);
+	writeRegister(0x08, 0x80);
+	writeRegister(0x09, 0x80);
+	writeRegister(0x0A, 0x80);
+	writeRegister(0x0B, 0x80);
+	writeRegister(0x0C, 0x80);
+	writeRegister(0x0D, 0x80);
+	writeRegister(0x0F, 0x00);
+	writeRegister(0x0E, 0x07);
+	hostAdvanceMicros(4000000UL);
+	CHECK_EQUAL(0, readRegister(0x0F) & 0x03);
+	hostAdvanceMicros(1000000UL);
+	CHECK_EQUAL(0x01, readRegister(0x0F) & 0x03);
+	CHECK(rtc.isInterrupt(DS1337SIM_INTA));
+	hostAdvanceMicros(5000000UL);
+	CHECK_EQUAL(0x03, readRegister(0x0F) & 0x03);
+
+	// writing 1 leaves a flag unchanged
+	writeRegister(0x0F, 0x01);
+	CHECK_EQUAL(0x01, readRegister(0x0F) & 0x03);
+	writeRegister(0x0F, 0x00);
+	CHECK_EQUAL(0x00, readRegister(0x0F) & 0x83);
+	CHECK(!rtc.isInterrupt(DS1337SIM_INTA));
+}
+
+// OSF at power on and when the oscillator stops, time stands still meanwhile
+static void testOscillatorStop(DS1337Sim &rtc) {
+	rtc.powerOn();
+	CHECK(readRegister(0x0F) & 0x80);
+	writeRegister(0x0F, 0x00);
+	CHECK(!(readRegister(0x0F) & 0x80));
+	rtc.setTimestamp(1600000000UL);
+	rtc.haltOscillator(true);
+	hostAdvanceMicros(5000000UL);
+	CHECK_EQUAL(1600000000UL, rtc.getTimestamp());
+	CHECK(readRegister(0x0F) & 0x80);
+	rtc.haltOscillator(false);
+	hostAdvanceMicros(2000000UL);
+	CHECK_EQUAL(1600000002UL, rtc.getTimestamp());
+}
+
+// DS1337 stops with EOSC, no temperature registers
+static void testDS1337() {
+	DS1337Sim rtc(false);
+	Wire.attach(0x68, rtc);
+	testCalendar(rtc);
+	testPointer(rtc);
+	testAlarms(rtc);
+	testOscillatorStop(rtc);
+	writeRegister(0x0F, 0x00);
+	rtc.setTimestamp(1600000000UL);
+	writeRegister(0x0E, 0x80);
+	CHECK(readRegister(0x0F) & 0x80);
+	hostAdvanceMicros(3000000UL);
+	CHECK_EQUAL(1600000000UL, rtc.getTimestamp());
+	Wire.detach(rtc);
+}
+
+// DS3231 conversions: BSY/CONV for 200 ms, new temperature afterwards, EN32KHZ is read/write
+static void testDS3231() {
+	DS1337Sim rtc(true);
+	Wire.attach(0x68, rtc);
+	testCalendar(rtc);
+	testPointer(rtc);
+	testAlarms(rtc);
+	testOscillatorStop(rtc);
+
+	rtc.powerOn();
+	CHECK(readRegister(0x0F) & 0x08);
+	writeRegister(0x0F, 0x00);
+	CHECK(!(readRegister(0x0F) & 0x08));
+
+	hostAdvanceMicros(rtc.microsToNextSecond() + 300000UL);
+	rtc.setTemperatureQuarters(-42);
+	writeRegister(0x0E, 0x3C);
+	CHECK(readRegister(0x0E) & 0x20);
+	CHECK(readRegister(0x0F) & 0x04);
+	hostAdvanceMicros(100000UL);
+	CHECK(readRegister(0x0F) & 0x04);
+	hostAdvanceMicros(100000UL);
+	CHECK(!(readRegister(0x0F) & 0x04));
+	CHECK(!(readRegister(0x0E) & 0x20));
+	CHECK_EQUAL(-11, (int8_t)readRegister(0x11));
+	CHECK_EQUAL(0x80, readRegister(0x12));
+
+	// temperature registers are read only, BSY can't be written
+	writeRegister(0x11, 0x55);
+	CHECK_EQUAL(-11, (int8_t)readRegister(0x11));
+	writeRegister(0x0F, 0x04);
+	CHECK(!(readRegister(0x0F) & 0x04));
+
+	// automatic conversion every 64 seconds
+	unsigned long conversions = rtc.getConversions();
+	hostAdvanceMicros(128UL * 1000000UL);
+	CHECK_EQUAL(conversions + 2, rtc.getConversions());
+
+	// aging offset applies after the next conversion (+10 ppm: 10 us/s slower)
+	rtc.setDrift(0);
+	writeRegister(0x10, 100);
+	writeRegister(0x0E, 0x3C);
+	hostAdvanceMicros(250000UL);
+	rtc.setTimestamp(1600000000UL);
+	hostAdvanceMicros(100000000UL);
+	CHECK_EQUAL(1600000099UL, rtc.getTimestamp());
+	Wire.detach(rtc);
+}
+
+// bus time: start, stop and 9 bits per byte at 100/400 kHz
+static void testBusCost() {
+	DS1337Sim rtc(false);
+	Wire.attach(0x68, rtc);
+	uint8_t r[7];
+
+	Wire.setClock(100000UL);
+	Wire.resetStatistics();
+	unsigned long long start = hostMicros();
+	readRegisters(0, r, 7);
+	CHECK_EQUAL(2, Wire.getTransactions());
+	CHECK_EQUAL(10, Wire.getBytes());
+	CHECK_EQUAL(940, Wire.getBusMicros());
+	CHECK_EQUAL(940, hostMicros() - start);
+
+	Wire.setClock(400000UL);
+	Wire.resetStatistics();
+	start = hostMicros();
+	readRegisters(0, r, 7);
+	CHECK_EQUAL(235, Wire.getBusMicros());
+	CHECK_EQUAL(235, hostMicros() - start);
+
+	// no device: address not acknowledged, the address byte is charged anyway
+	Wire.resetStatistics();
+	Wire.beginTransmission(0x50);
+	CHECK_EQUAL(2, Wire.endTransmission());
+	CHECK_EQUAL(1, Wire.getBytes());
+	Wire.setClock(100000UL);
+	Wire.detach(rtc);
+}
+
+// devices behind a multiplexer only answer on a connected channel
+static void testMux() {
+	WireMux mux;
+	DS1337Sim a(false), b(true);
+	Wire.attach(0x70, mux);
+	Wire.attach(0x68, a, mux, 0);
+	Wire.attach(0x68, b, mux, 3);
+	Wire.beginTransmission(0x68);
+	CHECK_EQUAL(2, Wire.endTransmission());
+	Wire.beginTransmission(0x70);
+	Wire.write(1 << 3);
+	Wire.endTransmission();
+	CHECK_EQUAL(19, Wire.requestFrom(0x68, 19));
+	Wire.beginTransmission(0x70);
+	Wire.write((1 << 3) | 1);
+	Wire.endTransmission();
+	Wire.resetStatistics();
+	Wire.beginTransmission(0x68);
+	Wire.endTransmission();
+	CHECK_EQUAL(1, Wire.getCollisions());
+	Wire.detach(mux);
+	Wire.detach(a);
+	Wire.detach(b);
+}
+
+int main() {
+	hostReset();
+	testDS1337();
+	testDS3231();
+	testBusCost();
+	testMux();
+	return testResult();
+}
@@ -0,0 +1,90 @@
+/**
+
+test_stats.cpp
+
+Copyright by Christian Paul, 2014
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+ */
+#include "HostTest.h"
+#include "DS1337Sim.h"
+#include "DS1337Group.h"
+
+// linked against the library compiled with DS1337_STATS, this file without:
+// both must agree on the layout of DS1337
+
+// counters of single register accesses
+static void testCounters(DS1337 &rtc) {
+	rtc.resetStats();
+	rtc.getDate();
+	DS1337Stats stats = rtc.getStats();
+	CHECK_EQUAL(1UL, stats.reads);
+	CHECK_EQUAL(0UL, stats.writes);
+	CHECK_EQUAL(2UL, stats.transactions);
+	CHECK_EQUAL((unsigned long)DS1337_REGISTERS_DATE, stats.bytesRead);
+	CHECK_EQUAL(rtc.getTransport()->getReadMicros(DS1337_REGISTERS_DATE), stats.busMicros);
+	CHECK(stats.micros >= stats.busMicros);
+
+	// read-modify-write of the date
+	rtc.setDateTime(24, 2, 29, 12, 0, 0);
+	stats = rtc.getStats();
+	CHECK_EQUAL(2UL, stats.reads);
+	CHECK_EQUAL(1UL, stats.writes);
+	CHECK_EQUAL(5UL, stats.transactions);
+	CHECK_EQUAL((unsigned long)DS1337_REGISTERS_DATE, stats.bytesWritten);
+
+	rtc.resetStats();
+	stats = rtc.getStats();
+	CHECK(stats.transactions == 0 && stats.reads == 0 && stats.writes == 0);
+	CHECK(stats.bytesRead == 0 && stats.bytesWritten == 0 && stats.busMicros == 0);
+}
+
+// the cost of one API call is the difference of two snapshots
+static void testCallCost(DS1337 &rtc) {
+	DS1337Stats before = rtc.getStats();
+	rtc.setAlarmMode(DS1337_ALARM_ON_SECOND);
+	DS1337Stats after = rtc.getStats();
+	CHECK_EQUAL(1UL, after.reads - before.reads);
+	CHECK_EQUAL(1UL, after.writes - before.writes);
+	CHECK_EQUAL(3UL, after.transactions - before.transactions);
+}
+
+// the group takes the measured bus time of a snapshot
+static void testGroup(DS1337 &rtc) {
+	DS1337Group group;
+	group.add(rtc);
+	DS1337Stats before = rtc.getStats();
+	CHECK(group.poll());
+	DS1337Stats after = rtc.getStats();
+	CHECK(after.busMicros > before.busMicros);
+	CHECK_EQUAL(after.busMicros - before.busMicros, group.getBusMicros(0));
+}
+
+int main() {
+	hostReset();
+	DS1337Sim sim(false);
+	Wire.attach(DS1337_ID, sim);
+	DS1337 rtc;
+	rtc.init();
+	testCounters(rtc);
+	testCallCost(rtc);
+	testGroup(rtc);
+	return testResult();
+}
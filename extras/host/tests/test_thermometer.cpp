@@ -0,0 +1,119 @@
+/**
+
+test_thermometer.cpp
+
+Copyright by Christian Paul, 2014
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+ */
+#include "HostTest.h"
+#include "DS1337Sim.h"
+#include "DS3231Thermometer.h"
+
+// quarter degrees of the samples, the extremes drop out of the buffer
+static const int temperatures[] = { 100, -20, 40, 41, 42, 43, 44, 45, 46, 47, 48, 49, 50, 51, 52, 53, 54, 90, -3, 55 };
+#define SAMPLES (int)(sizeof(temperatures) / sizeof(temperatures[0]))
+
+// one conversion: start it, wait for the DS3231, read the sample
+static boolean sample(DS3231Thermometer &thermometer, unsigned long timestamp) {
+	CHECK(!thermometer.poll(timestamp));
+	hostAdvanceMicros(DS3231SIM_CONVERSION_MICROS + 10000);
+	return thermometer.poll(timestamp);
+}
+
+// min/max/mean of the newest samples in the buffer (mean rounded like getMean)
+static void expected(int last, int &minimum, int &maximum, int &mean) {
+	int first = last + 1 > DS3231_THERMOMETER_SIZE ? last + 1 - DS3231_THERMOMETER_SIZE : 0;
+	long sum = 0;
+	minimum = maximum = temperatures[first];
+	for (int i=first; i<=last; i++) {
+		sum += temperatures[i];
+		if (temperatures[i] < minimum)
+			minimum = temperatures[i];
+		if (temperatures[i] > maximum)
+			maximum = temperatures[i];
+	}
+	long count = last + 1 - first;
+	mean = sum < 0 ? (sum - count / 2) / count : (sum + count / 2) / count;
+}
+
+// ring buffer with min/max/mean over the samples kept
+static void testRing(DS3231Thermometer &thermometer, DS1337Sim &sim) {
+	unsigned long timestamp = 1700000000UL;
+	for (int i=0; i<SAMPLES; i++) {
+		sim.setTemperatureQuarters(temperatures[i]);
+		CHECK(sample(thermometer, timestamp));
+		CHECK_EQUAL(i < DS3231_THERMOMETER_SIZE ? i + 1 : DS3231_THERMOMETER_SIZE, thermometer.count());
+		int minimum, maximum, mean;
+		expected(i, minimum, maximum, mean);
+		CHECK_EQUAL(minimum, thermometer.getMinimum());
+		CHECK_EQUAL(maximum, thermometer.getMaximum());
+		CHECK_EQUAL(mean, thermometer.getMean());
+		DS3231Temperature last;
+		CHECK(thermometer.getLast(last));
+		CHECK_EQUAL(temperatures[i], last.temperature);
+		CHECK_EQUAL(timestamp, last.timestamp);
+		timestamp += DS3231_THERMOMETER_INTERVAL;
+	}
+	DS3231Temperature oldest;
+	CHECK(thermometer.get(0, oldest));
+	CHECK_EQUAL(temperatures[SAMPLES - DS3231_THERMOMETER_SIZE], oldest.temperature);
+	CHECK(!thermometer.get(DS3231_THERMOMETER_SIZE, oldest));
+}
+
+// no conversion before the interval has passed
+static void testInterval(DS3231Thermometer &thermometer) {
+	thermometer.clear();
+	thermometer.setInterval(10);
+	CHECK(sample(thermometer, 1000));
+	CHECK(!sample(thermometer, 1009));
+	CHECK_EQUAL(1, thermometer.count());
+	CHECK(sample(thermometer, 1010));
+	CHECK_EQUAL(2, thermometer.count());
+}
+
+// mean of negative temperatures rounds to the nearest quarter degree
+static void testNegative(DS3231Thermometer &thermometer, DS1337Sim &sim) {
+	thermometer.clear();
+	thermometer.setInterval(1);
+	CHECK_EQUAL(0, thermometer.getMean());
+	unsigned long timestamp = 2000;
+	const int values[] = { -40, -41, -41 };
+	for (int i=0; i<3; i++) {
+		sim.setTemperatureQuarters(values[i]);
+		CHECK(sample(thermometer, timestamp++));
+	}
+	CHECK_EQUAL(-41, thermometer.getMean());
+	CHECK_EQUAL(-41, thermometer.getMinimum());
+	CHECK_EQUAL(-40, thermometer.getMaximum());
+}
+
+int main() {
+	hostReset();
+	DS1337Sim sim(true);
+	Wire.attach(DS1337_ID, sim);
+	DS3231 rtc;
+	rtc.init();
+	DS3231Thermometer thermometer(rtc);
+	testRing(thermometer, sim);
+	testInterval(thermometer);
+	testNegative(thermometer, sim);
+	return testResult();
+}
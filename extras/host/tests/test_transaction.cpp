@@ -0,0 +1,106 @@
+/**
+
+test_transaction.cpp
+
+Copyright by Christian Paul, 2014
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+ */
+#include "HostTest.h"
+#include "DS1337Sim.h"
+#include "DS1337.h"
+
+// stage a boot configuration, returns the number of bursts written by commit
+static unsigned long boot(DS1337 &rtc, int mergeGap) {
+	rtc.beginTransaction();
+	rtc.setDateTime(24, 3, 7, 9, 5, 30);
+	rtc.setAlarm(7, 9, 30, 0);
+	rtc.setAlarmMode(DS1337_ALARM_ON_SECOND_MINUTE_HOUR_DATE);
+	rtc.enableAlarm();
+	rtc.setTickMode(DS1337_NO_TICKS);
+	rtc.clearFlags();
+	Wire.resetStatistics();
+	rtc.commit(mergeGap);
+	return Wire.getTransactions();
+}
+
+// the whole boot configuration is written in one burst, the registers are correct
+static void testBoot() {
+	DS1337Sim sim(false);
+	Wire.attach(DS1337_ID, sim);
+	DS1337 rtc;
+	rtc.init();
+	CHECK_EQUAL(1, boot(rtc, DS1337_MAX_REGISTERS));
+	CHECK(!rtc.inTransaction());
+	CHECK_EQUAL(0x30, sim.peek(DS1337SIM_SECONDS));
+	CHECK_EQUAL(0x05, sim.peek(DS1337SIM_SECONDS + 1));
+	CHECK_EQUAL(0x09, sim.peek(DS1337SIM_SECONDS + 2));
+	CHECK_EQUAL(0x07, sim.peek(DS1337SIM_SECONDS + 4));
+	CHECK_EQUAL(0x03, sim.peek(DS1337SIM_MONTH));
+	CHECK_EQUAL(0x24, sim.peek(DS1337SIM_YEAR));
+	CHECK_EQUAL(0x00, sim.peek(DS1337SIM_A1_SECONDS));
+	CHECK_EQUAL(0x30, sim.peek(DS1337SIM_A1_SECONDS + 1));
+	CHECK_EQUAL(0x09, sim.peek(DS1337SIM_A1_SECONDS + 2));
+	CHECK_EQUAL(0x07, sim.peek(DS1337SIM_A1_SECONDS + 3));
+	CHECK_EQUAL(DS1337SIM_A1IE, sim.peek(DS1337SIM_CONTROL) & (DS1337SIM_A1IE | DS1337SIM_A2IE | DS1337SIM_EOSC));
+	CHECK_EQUAL(0, sim.peek(DS1337SIM_STATUS) & (DS1337SIM_OSF | DS1337SIM_A1F | DS1337SIM_A2F));
+	CHECK_EQUAL(DS1337_ALARM_ON_SECOND_MINUTE_HOUR_DATE, rtc.getAlarmMode());
+	CHECK_EQUAL(DS1337_NO_TICKS, rtc.getTickMode());
+
+	// without merging over the gap of unknown registers: one burst per span
+	rtc.invalidateCache();
+	CHECK(boot(rtc, 0) > 1);
+	Wire.detach(sim);
+}
+
+// flags read back in a transaction come from the bus, except the flags cleared in it
+static void testFlags() {
+	DS1337Sim sim(false);
+	Wire.attach(DS1337_ID, sim);
+	DS1337 rtc;
+	rtc.init();
+	rtc.clearOSF();
+	rtc.beginTransaction();
+	rtc.clearAlarm();
+	rtc.resetTick();
+	CHECK(!rtc.hasStopped());
+	CHECK(!rtc.isTickActive());
+	CHECK(!rtc.isAlarmActive());
+	rtc.commit();
+	CHECK(!rtc.hasStopped());
+
+	// a flag set by the hardware before the commit is kept, the cleared one is cleared
+	sim.poke(DS1337SIM_STATUS, DS1337SIM_A1F);
+	rtc.beginTransaction();
+	rtc.clearAlarm();
+	CHECK(!rtc.isAlarmActive());
+	sim.poke(DS1337SIM_STATUS, DS1337SIM_A1F | DS1337SIM_A2F);
+	CHECK(rtc.isTickActive());
+	rtc.commit();
+	CHECK_EQUAL(DS1337SIM_A2F, sim.peek(DS1337SIM_STATUS) & DS1337_STATUS_FLAGS);
+	Wire.detach(sim);
+}
+
+int main() {
+	hostReset();
+	testBoot();
+	testFlags();
+	return testResult();
+}